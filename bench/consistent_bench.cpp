@@ -0,0 +1,166 @@
+// Benchmarks for the lookup, replica and rebalance paths.
+//
+// Build with -DCONSISTENT_BUILD_BENCHMARKS=ON and run, for a machine-readable
+// report, as:
+//
+//   consistent_bench --benchmark_format=json --benchmark_out=bench.json
+
+#include <consistent/consistent.h>
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace consistent;
+
+namespace {
+
+constexpr size_t KEY_COUNT = 4096;
+
+std::vector<std::shared_ptr<Member>> MakeMembers(int count, int first = 0) {
+    std::vector<std::shared_ptr<Member>> members;
+    members.reserve(count);
+    for (int i = first; i < first + count; ++i) {
+        members.push_back(std::make_shared<GatewayMember>("gateway-" + std::to_string(i),
+                                                          "10.0." + std::to_string(i / 256) + "." +
+                                                              std::to_string(i % 256),
+                                                          8000));
+    }
+    return members;
+}
+
+const std::vector<std::string>& Keys() {
+    static const std::vector<std::string> keys = [] {
+        std::vector<std::string> out;
+        out.reserve(KEY_COUNT);
+        for (size_t i = 0; i < KEY_COUNT; ++i) {
+            out.push_back("user:" + std::to_string(i * 2654435761u) + ":session");
+        }
+        return out;
+    }();
+    return keys;
+}
+
+// Shared by every lookup benchmark, so threaded runs contend on one ring
+const Consistent& LookupRing() {
+    static const Consistent ring(MakeMembers(100), Config(CreateXXH3Hasher()));
+    return ring;
+}
+
+void BM_LocateKeyString(benchmark::State& state) {
+    const auto& ring = LookupRing();
+    const auto& keys = Keys();
+    size_t i = state.thread_index() * 97;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ring.LocateKey(keys[i++ % KEY_COUNT]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LocateKeyString)->ThreadRange(1, 8)->UseRealTime();
+
+void BM_LocateKeyBytes(benchmark::State& state) {
+    const auto& ring = LookupRing();
+    const auto& keys = Keys();
+    size_t i = state.thread_index() * 97;
+    for (auto _ : state) {
+        const std::string& key = keys[i++ % KEY_COUNT];
+        benchmark::DoNotOptimize(ring.LocateKey(reinterpret_cast<const uint8_t*>(key.data()), key.size()));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LocateKeyBytes)->ThreadRange(1, 8)->UseRealTime();
+
+void BM_LocateKeys(benchmark::State& state) {
+    const auto& ring = LookupRing();
+    const auto& keys = Keys();
+    std::vector<Member*> out;
+    for (auto _ : state) {
+        ring.LocateKeys(keys, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * KEY_COUNT);
+}
+BENCHMARK(BM_LocateKeys);
+
+void BM_GetClosestN(benchmark::State& state) {
+    const auto& ring = LookupRing();
+    const auto& keys = Keys();
+    int count = static_cast<int>(state.range(0));
+    std::vector<Member*> out(count);
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ring.GetClosestN(keys[i++ % KEY_COUNT], count, out.data()));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GetClosestN)->Arg(1)->Arg(2)->Arg(3)->Arg(5)->Arg(8)->Arg(16);
+
+void BM_GetClosestNPrecomputed(benchmark::State& state) {
+    static const Consistent ring = [] {
+        Config config(CreateXXH3Hasher());
+        config.precompute_replicas = 3;
+        return Consistent(MakeMembers(100), std::move(config));
+    }();
+    const auto& keys = Keys();
+    int count = static_cast<int>(state.range(0));
+    std::vector<Member*> out(count);
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ring.GetClosestN(keys[i++ % KEY_COUNT], count, out.data()));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GetClosestNPrecomputed)->Arg(1)->Arg(3);
+
+template <typename HasherT>
+void BM_Hash(benchmark::State& state) {
+    HasherT hasher;
+    std::vector<uint8_t> key(static_cast<size_t>(state.range(0)), 'k');
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(hasher.Sum64(key.data(), key.size()));
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_Hash, CRC64Hasher)->RangeMultiplier(4)->Range(8, 4096);
+BENCHMARK_TEMPLATE(BM_Hash, FNVHasher)->RangeMultiplier(4)->Range(8, 4096);
+BENCHMARK_TEMPLATE(BM_Hash, XXH3Hasher)->RangeMultiplier(4)->Range(8, 4096);
+BENCHMARK_TEMPLATE(BM_Hash, WyHasher)->RangeMultiplier(4)->Range(8, 4096);
+
+// Adds one member to a ring and removes it again: two full rebalances
+void BM_AddRemove(benchmark::State& state) {
+    int member_count = static_cast<int>(state.range(0));
+    int partition_count = static_cast<int>(state.range(1));
+    int replication_factor = static_cast<int>(state.range(2));
+
+    Consistent ring(MakeMembers(member_count),
+                    Config(CreateXXH3Hasher(), partition_count, replication_factor));
+    auto extra = MakeMembers(1, member_count).front();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ring.Add(extra));
+        benchmark::DoNotOptimize(ring.RemoveByName(extra->Name()));
+    }
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+
+// Only combinations the ring accepts: every member must fit at least one
+// partition, and the average load must stay within twice the replication factor
+void AddRemoveArgs(benchmark::internal::Benchmark* bench) {
+    for (int members : {10, 100, 1000}) {
+        for (int partitions : {271, 7919, 65521}) {
+            for (int replication : {20, 100}) {
+                double load = partitions * DEFAULT_LOAD / members;
+                if (load >= 1 && load <= replication * 2.0) {
+                    bench->Args({members, partitions, replication});
+                }
+            }
+        }
+    }
+}
+BENCHMARK(BM_AddRemove)->Apply(AddRemoveArgs)->ArgNames({"members", "partitions", "replication"})
+    ->Unit(benchmark::kMicrosecond);
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+namespace consistent {
+
+// ScratchArena is a monotonic memory resource for the temporaries of one
+// rebalance. Allocation bumps a pointer through a retained block and
+// deallocation is a no-op; Reset() rewinds the block. Requests that do not
+// fit go to operator new, and the next Reset() folds them into one larger
+// block, so once it has seen the largest rebalance the arena stops
+// allocating. Not thread-safe: callers hold the ring's writer lock.
+class ScratchArena final : public std::pmr::memory_resource {
+public:
+    static constexpr size_t INITIAL_SIZE = 64 * 1024;
+
+    explicit ScratchArena(size_t initial_size = INITIAL_SIZE);
+    ~ScratchArena() override;
+
+    ScratchArena(const ScratchArena&) = delete;
+    ScratchArena& operator=(const ScratchArena&) = delete;
+
+    // Invalidates everything allocated since the previous Reset
+    void Reset();
+
+    size_t Capacity() const { return size_; }
+
+private:
+    struct Overflow {
+        void* data;
+        size_t size;
+        size_t alignment;
+    };
+
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void*, size_t, size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    void ReleaseOverflow();
+
+    std::unique_ptr<std::byte[]> block_;
+    size_t size_;
+    size_t used_ = 0;
+    std::vector<Overflow> overflow_;
+    size_t overflow_bytes_ = 0;
+};
+
+// Rebalance temporaries, allocated from a ScratchArena
+template <typename T>
+using ScratchVector = std::pmr::vector<T>;
+
+} // namespace consistent
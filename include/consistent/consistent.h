@@ -1,21 +1,36 @@
 #pragma once
 
 #include "member.h"
+#include "arena.h"
 #include "hasher.h"
+#include "epoch.h"
+#include "placement.h"
+#include "ring.h"
+#include "sketch.h"
+#include "stats.h"
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
 #include <vector>
 #include <map>
 #include <unordered_map>
 #include <unordered_set>
 #include <memory>
 #include <mutex>
-#include <shared_mutex>
 #include <stdexcept>
+#include <string_view>
+#include <thread>
 
 namespace consistent {
 
 constexpr int DEFAULT_PARTITION_COUNT = 271;
 constexpr int DEFAULT_REPLICATION_FACTOR = 20;
 constexpr double DEFAULT_LOAD = 1.25;
+constexpr size_t LOCATE_BATCH_SIZE = 64;
+constexpr int MAX_HOT_KEY_REPLICAS = 16;
 
 class InsufficientMemberCountException : public std::runtime_error {
 public:
@@ -27,12 +42,115 @@ public:
     InsufficientSpaceException(const std::string& msg) : std::runtime_error(msg) {}
 };
 
+class InvalidSnapshotException : public std::runtime_error {
+public:
+    InvalidSnapshotException(const std::string& msg) : std::runtime_error(msg) {}
+};
+
+class InvalidDeltaException : public std::runtime_error {
+public:
+    InvalidDeltaException(const std::string& msg) : std::runtime_error(msg) {}
+};
+
+// The delta was encoded against a different ring epoch than the one it is
+// applied to; the ring has to be resynced from a snapshot.
+class StaleRingException : public std::runtime_error {
+public:
+    StaleRingException(const std::string& msg) : std::runtime_error(msg) {}
+};
+
+constexpr uint32_t SNAPSHOT_VERSION = 3;
+constexpr uint32_t DELTA_VERSION = 1;
+
+// A partition whose owner changed during a membership change. from is null for
+// partitions that had no owner before; to is null once the ring is empty.
+struct PartitionMove {
+    int part_id;
+    std::shared_ptr<Member> from;
+    std::shared_ptr<Member> to;
+};
+
+// Receives the moves of each membership change right after the new ring is
+// published. It runs with the writer lock held, so events arrive in order and
+// the callback must not change membership itself.
+using MigrationCallback = std::function<void(const std::vector<PartitionMove>&)>;
+
+// Members and loads of one published ring. Built once per change and shared
+// by every reader until the next change replaces it. loads has an entry for
+// every member, 0 for one that owns no partition.
+struct MemberView {
+    uint64_t epoch = 0;
+    std::vector<std::shared_ptr<Member>> members;
+    std::unordered_map<std::string, double> loads;
+};
+
+// Receives the encoded delta of each published change together with the epoch
+// it produces; see BasicConsistent::ApplyDelta. Same ordering guarantees as
+// MigrationCallback.
+using DeltaCallback = std::function<void(uint64_t epoch, const std::vector<uint8_t>& delta)>;
+
+// How LocateKey maps a key to a member: through its partition (bounded load),
+// or straight to the next virtual node clockwise (classic consistent hashing).
+enum class LookupMode {
+    Partition,
+    Ring,
+};
+
 // Config .
 struct Config {
     std::unique_ptr<Hasher> hasher;
     int partition_count = DEFAULT_PARTITION_COUNT;
     int replication_factor = DEFAULT_REPLICATION_FACTOR;
     double load = DEFAULT_LOAD;
+
+    // Rebalance membership changes incrementally: only partitions captured by a
+    // new member's virtual nodes, orphaned by a removed member, or above the new
+    // load bound move. This minimizes movement but makes placement depend on
+    // the order of membership changes, so it is off by default.
+    bool incremental_rebalance = false;
+
+    // When positive, the first precompute_replicas distinct members of every
+    // partition are computed once per membership change, so GetClosestN with a
+    // count up to this serves from a table instead of walking the ring.
+    int precompute_replicas = 0;
+
+    LookupMode lookup_mode = LookupMode::Partition;
+
+    // Members only shed partitions for traffic (in RebalanceByLoad and after
+    // membership changes) once they are more than this fraction above their
+    // traffic bound, which keeps partitions from flapping around the bound.
+    double load_hysteresis = 0.1;
+
+    // Hot-key spreading: with a positive hot_key_sketch_width, LocateKey and
+    // LocateKeySpread sample keys (see HotKeySketch::SAMPLE_INTERVAL) into a
+    // Count-Min sketch of that many counters per row. Keys making up at least
+    // hot_key_threshold of recent lookups are hot, and LocateKeySpread sends
+    // them to one of their first hot_key_replicas members, picked by power of
+    // two choices.
+    size_t hot_key_sketch_width = 0;
+    double hot_key_threshold = 0.01;
+    int hot_key_replicas = 3;
+
+    // Threads used to hash partition IDs and find their ring positions when
+    // partitions are (re)distributed; 0 uses every hardware thread. The
+    // bounded-load assignment itself stays serial, so the result is the same
+    // for any thread count. Rings under 4096 partitions always run serially.
+    // The ring keeps distribution_threads - 1 workers alive for its lifetime.
+    int distribution_threads = 1;
+
+    // Bits of the hash used for the ring's jump table (0 disables it, max 24).
+    // Speeds up every ring search, at 4 << ring_index_bits bytes per state.
+    int ring_index_bits = 0;
+
+    MigrationCallback on_partition_moves;
+
+    // Set on a coordinator to replicate its changes to other rings. Deltas are
+    // only encoded while this is set.
+    DeltaCallback on_ring_delta;
+
+    // Receives every published change when instrumentation is compiled in;
+    // see stats.h.
+    StatsSink stats_sink;
     
     Config() = default;
     Config(std::unique_ptr<Hasher> h, int pc = DEFAULT_PARTITION_COUNT, 
@@ -40,73 +158,321 @@ struct Config {
         : hasher(std::move(h)), partition_count(pc), replication_factor(rf), load(l) {}
 };
 
-// Consistent hash ring
-class Consistent {
+// Consistent hash ring.
+//
+// HasherT fixes the hash function at compile time. With one of the built-in
+// (final) hashers every Sum64 call is resolved statically instead of going
+// through the vtable; Consistent keeps the type-erased, runtime-chosen form.
+// config.hasher must hold a HasherT (it is created when left empty).
+template <typename HasherT>
+class BasicConsistent {
 private:
-    mutable std::shared_mutex mutex_;
-    
+    // Immutable view of the ring. Writers build a new State off to the side and
+    // publish it with an atomic pointer swap, so readers never take a lock. The
+    // State owns its members, keeping every raw Member* below valid until the
+    // State is reclaimed.
+    //
+    // Ring entries and partition owners are slots of the SlotTable. loads is
+    // indexed by slot too, so rebalancing never touches a string.
+    struct State : SlotTable {
+        std::unordered_map<std::string, std::shared_ptr<Member>> members;
+        std::shared_ptr<const MemberView> view;
+        std::vector<uint32_t> loads;
+        Ring ring;
+
+        // replica_count slots per partition, closest first; see precompute_replicas
+        int replica_count = 0;
+        std::vector<uint32_t> replicas;
+        std::vector<uint32_t> partitions;
+
+        // Bumped by every published change
+        uint64_t epoch = 0;
+    };
+
     Config config_;
-    std::vector<uint64_t> sorted_set_;
+    const HasherT* hasher_ = nullptr;
     uint64_t partition_count_;
-    std::unordered_map<std::string, double> loads_;
-    std::unordered_map<std::string, std::shared_ptr<Member>> members_;
-    std::unordered_map<int, Member*> partitions_;
-    std::unordered_map<uint64_t, Member*> ring_;
-
-    mutable std::vector<Member*> cached_members_;
-    mutable bool members_dirty_ = true;
-
-    void InitMember(std::shared_ptr<Member> member);
-    void DistributePartitions();
-    void DistributeWithLoad(int part_id, int idx,
-                           std::unordered_map<int, Member*>& partitions,
-                           std::unordered_map<std::string, double>& loads);
-
-    std::pair<std::unordered_map<int, Member*>, std::unordered_map<std::string, double>>
-    CalculatePartitionsWithRingAndMemberCount(
-        const std::unordered_map<uint64_t, Member*>& ring,
-        const std::vector<uint64_t>& sorted_set,
-        int member_count);
 
-    // Member management helpers
-    std::pair<std::unordered_map<int, Member*>, std::unordered_map<std::string, double>>
-    CalculatePartitionsWithNewMember(const std::string& member_name);
+    // Hash of each partition ID; fixed for the lifetime of the ring
+    PartitionKeys partition_keys_;
+    // Runs the partition sweeps on distribution_threads threads; writer-only
+    mutable WorkerPool distribution_pool_;
 
-    std::pair<std::unordered_map<int, Member*>, std::unordered_map<std::string, double>>
-    CalculatePartitionsWithoutMember(const std::string& member_name);
+    std::atomic<const State*> state_{nullptr};
+    mutable EpochDomain epoch_;
+    std::mutex write_mutex_;
+    mutable StatsCollector stats_;
 
-    void AddToRing(std::shared_ptr<Member> member);
-    void RemoveFromRing(const std::string& name);
-    void DelSlice(uint64_t val);
+    // Writer-only storage, reused from one change to the next: scratch_ holds
+    // rebalance temporaries and spare_state_ the last retired state, whose
+    // containers the next change copies into instead of allocating afresh.
+    mutable ScratchArena scratch_;
+    std::unique_ptr<State> spare_state_;
+
+    // Changes queued by AddAsync/RemoveAsync. The worker is started by the
+    // first queued change and drains the queue before the ring is destroyed.
+    struct QueuedChange {
+        std::shared_ptr<Member> add; // Null for a removal
+        std::string remove;
+        std::promise<std::vector<PartitionMove>> done;
+    };
+    std::deque<QueuedChange> change_queue_;
+    std::mutex change_queue_mutex_;
+    std::condition_variable change_queue_cv_;
+    std::thread change_worker_;
+    bool stop_change_worker_ = false;
+
+    // Observed request rate per partition, fed by RecordPartitionLoad
+    std::vector<double> partition_traffic_;
+    std::mutex traffic_mutex_;
+
+    // Hot-key detection, and requests LocateKeySpread sent to each member
+    // (by name hash) to compare replicas
+    static constexpr size_t SPREAD_COUNTER_COUNT = 1024;
+    std::unique_ptr<HotKeySketch> sketch_;
+    mutable std::array<std::atomic<uint64_t>, SPREAD_COUNTER_COUNT> spread_counts_{};
+
+    // A state a writer is building. Unless released for publishing, it is
+    // parked in spare_state_ when it goes out of scope, so a change that
+    // returns early or throws still leaves its storage to the next one.
+    class Draft {
+    public:
+        Draft(BasicConsistent& ring, std::unique_ptr<State> state) : ring_(ring), state_(std::move(state)) {}
+        Draft(const Draft&) = delete;
+        Draft& operator=(const Draft&) = delete;
+        ~Draft() {
+            if (state_) {
+                ring_.ParkState(std::move(state_));
+            }
+        }
+
+        State& operator*() const { return *state_; }
+        State* operator->() const { return state_.get(); }
+        std::unique_ptr<State> Release() { return std::move(state_); }
+
+    private:
+        BasicConsistent& ring_;
+        std::unique_ptr<State> state_;
+    };
+
+    void Publish(std::unique_ptr<State> next);
+    // Copy of current for a writer to change, built in spare_state_ when there is one
+    Draft NextState(const State& current);
+    // Keeps state's storage in spare_state_, dropping the members and view it holds
+    void ParkState(std::unique_ptr<State> state);
+
+    void InitMember(State& state, std::shared_ptr<Member> member);
+    void DistributePartitions(State& state);
+
+    // Recomputes state.partitions and state.loads from state.ring, recording
+    // reassigned partitions in log when given
+    void CalculatePartitionsWithRingAndMemberCount(State& state, int member_count, TrafficBound& bound,
+                                                   MoveLog* log);
+    void AssignPartitions(State& state, const ScratchVector<double>& caps, TrafficBound& bound, MoveLog* log);
+
+    // Moves only the partitions affected by the added and removed members.
+    // next starts as a copy of current with the membership change applied.
+    void RebalanceIncrementally(const State& current, State& next, const std::vector<Member*>& added,
+                                const std::vector<Member*>& removed, TrafficBound& bound, MoveLog& log);
+
+    // Recorded traffic with caps for state's members, and what each slot owns in state.partitions
+    TrafficBound RecordedTraffic(const State& state);
+    // Moves partitions off members more than load_hysteresis above their
+    // traffic bound; returns whether any moved
+    bool ShedTraffic(State& next, TrafficBound& bound, MoveLog& log);
+    // Moves of the partitions in log whose owner member differs between
+    // before and after, in partition ID order
+    std::vector<PartitionMove> CollectMoves(const State& before, const State& after, MoveLog& log) const;
+    void NotifyMoves(const std::vector<PartitionMove>& moves) const;
+    std::future<std::vector<PartitionMove>> EnqueueChange(QueuedChange change);
+    void RunChangeWorker();
+
+    // Encodes the change from current to next for ApplyDelta. removed holds the
+    // names of removed members, added the slots of added ones, and log the
+    // partitions reassigned, already deduped by CollectMoves.
+    std::vector<uint8_t> EncodeDelta(const State& current, const State& next,
+                                     const std::vector<std::string>& removed,
+                                     const std::vector<uint32_t>& added, const MoveLog& log) const;
+    void NotifyDelta(uint64_t epoch, const std::vector<uint8_t>& delta) const;
+
+    // Hash of a fixed probe; snapshots and deltas only load into rings with the same hasher
+    uint64_t HasherFingerprint() const;
+    static size_t FindStartIndex(const State& state, uint64_t key);
+
+    // Start positions of every partition (see PartitionKeys), split across
+    // distribution_pool_
+    ScratchVector<uint32_t> FindStartIndices(const State& state) const;
+
+    // consistent::FindOwnerWithCapacity, counting its probes
+    uint32_t FindOwnerWithCapacity(const State& state, uint64_t part_id, size_t idx,
+                                   const ScratchVector<double>& caps, const TrafficBound& bound,
+                                   uint32_t skip) const;
+
+    // Per-slot load bounds (see consistent::LoadCaps). The constructor keeps
+    // the fractional bound; later rebalances round it up.
+    ScratchVector<double> LoadCaps(const State& state, bool ceiled) const;
+
+    // Member management helpers
+    uint32_t AddToRing(State& state, std::shared_ptr<Member> member, const std::string& name);
+    static void RefreshMemberView(State& state);
+    uint32_t AcquireSlot(State& state, Member* member, const std::string& name) const;
+    static uint32_t ReleaseSlot(State& state, Member* member);
     
-    // Key location helpers
-    int GetPartitionID(const std::vector<uint8_t>& key) const;
-    int GetPartitionID(const std::string& key) const;
-    Member* GetPartitionOwner(int part_id) const;
-    std::vector<std::shared_ptr<Member>> GetClosestN(int part_id, int count) const;
+    // Key location helpers. The public overloads start the lookup timer
+    // before hashing, so the LocateHash variants do not time themselves.
+    int GetPartitionID(uint64_t hkey) const;
+    std::shared_ptr<Member> LocateHash(uint64_t hkey) const;
+    std::shared_ptr<Member> LocateHashOnRing(uint64_t hkey) const;
+    std::shared_ptr<Member> LocateHashSpread(uint64_t hkey) const;
+    Member* LocateOwner(const State& state, uint64_t hkey) const;
+    std::vector<std::shared_ptr<Member>> GetClosestNByHash(uint64_t hkey, int count) const;
+
+    template <typename Key>
+    void LocateKeysImpl(const std::vector<Key>& keys, std::vector<Member*>& out) const;
+    template <typename Key>
+    void LocatePartitionIDsImpl(const std::vector<Key>& keys, std::vector<int>& out) const;
+    static Member* GetPartitionOwner(const State& state, int part_id);
+    int GetClosestN(const State& state, int part_id, int count, Member** out) const;
+    // Closest members from the partition owner's name hash; Out is Member* or uint32_t (slot)
+    template <typename Out>
+    int WalkClosestN(const State& state, int part_id, int count, Out* out) const;
+    void RefreshReplicas(State& state) const;
     
-    double AverageLoad() const;
-    std::vector<uint8_t> BuildVirtualNodeKey(const std::string& member_str, int index) const;
+    double AverageLoad(const State& state) const;
     
     // Validation
     static void ValidateConfig(int member_count, const Config& config);
 
 public:
-    Consistent(const std::vector<std::shared_ptr<Member>>& members, Config config);
+    BasicConsistent(const std::vector<std::shared_ptr<Member>>& members, Config config);
+    ~BasicConsistent();
+
+    BasicConsistent(const BasicConsistent&) = delete;
+    BasicConsistent& operator=(const BasicConsistent&) = delete;
     
-    void Add(std::shared_ptr<Member> member);
-    void Remove(const Member& member);
-    void RemoveByName(const std::string& name);
+    // Membership changes return the partitions that changed owner
+    std::vector<PartitionMove> Add(std::shared_ptr<Member> member);
+    std::vector<PartitionMove> Remove(const Member& member);
+    std::vector<PartitionMove> RemoveByName(const std::string& name);
+
+    // Applies removes, then adds, with a single rebalance and a single publish.
+    // Unknown names and already present members are skipped.
+    std::vector<PartitionMove> ApplyChanges(const std::vector<std::shared_ptr<Member>>& adds,
+                                            const std::vector<std::string>& removes);
+    std::vector<PartitionMove> AddMany(const std::vector<std::shared_ptr<Member>>& members);
+    std::vector<PartitionMove> RemoveMany(const std::vector<std::string>& names);
+
+    // Queue a change for a background worker and return right away. The worker
+    // folds consecutive queued changes into one ApplyChanges, splitting only
+    // where a name repeats, and completes each future with the moves of the
+    // change set its request was applied in (or with its exception).
+    // on_partition_moves then runs on the worker thread.
+    std::future<std::vector<PartitionMove>> AddAsync(std::shared_ptr<Member> member);
+    std::future<std::vector<PartitionMove>> RemoveAsync(const std::string& name);
+
+    // Load feedback: report the observed request rate of partitions. Once any
+    // traffic is recorded, every membership change also bounds each member's
+    // traffic by its weighted share (times Config::load): partitions are
+    // placed heaviest first on the first member with room under both bounds,
+    // falling back to the partition count bound only when no member has
+    // traffic room. RebalanceByLoad applies the traffic bound between
+    // membership changes, moving partitions off members more than
+    // load_hysteresis above it.
+    void RecordPartitionLoad(int part_id, double qps);
+    void RecordPartitionLoads(const std::vector<double>& qps);
+    std::vector<PartitionMove> RebalanceByLoad();
+
+    // Replication: every published change advances the ring epoch by one. A
+    // coordinator encodes each change as a compact delta (see
+    // Config::on_ring_delta) and other rings built from the same members and
+    // config apply it with ApplyDelta, which replays the membership change and
+    // partition moves without recomputing the distribution. members supplies
+    // the objects for added member names. A delta made against another epoch
+    // raises StaleRingException and a damaged or mismatching one
+    // InvalidDeltaException; the ring is left untouched either way.
+    uint64_t Epoch() const;
+    std::vector<PartitionMove> ApplyDelta(const uint8_t* data, size_t size,
+                                          const std::vector<std::shared_ptr<Member>>& members);
 
     // Returns shared_ptr for absolute safety - objects remain valid as long as shared_ptr exists
     std::shared_ptr<Member> LocateKey(const std::vector<uint8_t>& key) const;
     std::shared_ptr<Member> LocateKey(const std::string& key) const;
+    // Zero-copy overloads for keys that live in caller-owned buffers
+    std::shared_ptr<Member> LocateKey(std::string_view key) const;
+    std::shared_ptr<Member> LocateKey(const char* key) const;
+    std::shared_ptr<Member> LocateKey(const uint8_t* data, size_t length) const;
+
+    // Classic consistent hashing: the key goes to the member owning the next
+    // virtual node clockwise, bypassing partitions and load bounds. This is
+    // what LocateKey does when lookup_mode is LookupMode::Ring.
+    std::shared_ptr<Member> LocateKeyOnRing(std::string_view key) const;
+    std::shared_ptr<Member> LocateKeyOnRing(const uint8_t* data, size_t length) const;
+
+    // Same as LocateKey unless the key is hot (see Config::hot_key_sketch_width),
+    // in which case the less loaded of two random replicas is returned.
+    std::shared_ptr<Member> LocateKeySpread(std::string_view key) const;
+    std::shared_ptr<Member> LocateKeySpread(const uint8_t* data, size_t length) const;
+    bool IsHotKey(std::string_view key) const;
+
+    // Batch lookups: the ring is pinned once for the whole batch and keys are
+    // hashed back to back. out is resized to keys.size(). The raw pointers skip
+    // the refcount bump and stay valid while the member remains in the ring.
+    void LocateKeys(const std::vector<std::string>& keys, std::vector<Member*>& out) const;
+    void LocateKeys(const std::vector<std::string_view>& keys, std::vector<Member*>& out) const;
+    void LocatePartitionIDs(const std::vector<std::string>& keys, std::vector<int>& out) const;
+    void LocatePartitionIDs(const std::vector<std::string_view>& keys, std::vector<int>& out) const;
+
     std::vector<std::shared_ptr<Member>> GetClosestN(const std::vector<uint8_t>& key, int count) const;
     std::vector<std::shared_ptr<Member>> GetClosestN(const std::string& key, int count) const;
+    std::vector<std::shared_ptr<Member>> GetClosestN(std::string_view key, int count) const;
+    std::vector<std::shared_ptr<Member>> GetClosestN(const char* key, int count) const;
+    std::vector<std::shared_ptr<Member>> GetClosestN(const uint8_t* data, size_t length, int count) const;
+
+    // Writes the count closest members into out, which must have room for
+    // count entries, and returns how many were written. Nothing is allocated;
+    // the raw pointers stay valid while the member remains in the ring.
+    int GetClosestN(std::string_view key, int count, Member** out) const;
     
+    // GetMemberView hands out the current view without copying or locking;
+    // GetMembers and LoadDistribution return copies of its contents.
+    std::shared_ptr<const MemberView> GetMemberView() const;
     std::vector<std::shared_ptr<Member>> GetMembers() const;
     std::unordered_map<std::string, double> LoadDistribution() const;
     double GetAverageLoad() const;
+
+    // Lookup, GetClosestN and rebalance totals since construction. All zero
+    // unless built with CONSISTENT_ENABLE_STATS.
+    RingStats Stats() const;
+
+    // Snapshots: Serialize writes the full ring state (member names and
+    // weights, virtual nodes, partition owners, loads, epoch, hasher
+    // fingerprint and placement config) into a versioned, checksummed flat
+    // binary image. All sections are 8-byte aligned arrays, so the image can
+    // be written to a file and memory-mapped back.
+    //
+    // LoadSnapshot validates an image against config, binds each serialized
+    // name to the member with that name in members, and takes the ring over
+    // from it. Nothing is rehashed or redistributed; loads are recounted
+    // from the partition owners. Members missing from the list or listed
+    // twice, weights other than the members' own, a different hasher or
+    // placement config, or a damaged image raise InvalidSnapshotException.
+    // LoadSnapshotFile maps the file and loads from the mapping.
+    std::vector<uint8_t> Serialize() const;
+    static std::unique_ptr<BasicConsistent> LoadSnapshot(const uint8_t* data, size_t size,
+                                                         const std::vector<std::shared_ptr<Member>>& members,
+                                                         Config config);
+    static std::unique_ptr<BasicConsistent> LoadSnapshotFile(const std::string& path,
+                                                             const std::vector<std::shared_ptr<Member>>& members,
+                                                             Config config);
 };
 
+using Consistent = BasicConsistent<Hasher>;
+
+// Instantiated in consistent.cpp
+extern template class BasicConsistent<Hasher>;
+extern template class BasicConsistent<CRC64Hasher>;
+extern template class BasicConsistent<FNVHasher>;
+extern template class BasicConsistent<XXH3Hasher>;
+extern template class BasicConsistent<WyHasher>;
+
 } // namespace consistent
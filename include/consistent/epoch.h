@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+namespace consistent {
+
+// EpochDomain is a small sleepable-RCU style reclamation scheme. Readers mark
+// themselves active in one of a fixed set of cacheline-padded slots, so the
+// read path is a single uncontended atomic increment/decrement and never
+// touches a lock. Writers publish a new object with an atomic pointer swap and
+// then call Synchronize() before freeing the old one.
+class EpochDomain {
+public:
+    static constexpr size_t SLOT_COUNT = 64;
+
+    class ReadGuard {
+    public:
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+        ~ReadGuard();
+
+    private:
+        friend class EpochDomain;
+        ReadGuard(const EpochDomain& domain);
+
+        const EpochDomain& domain_;
+        size_t slot_;
+        unsigned epoch_;
+    };
+
+    EpochDomain() = default;
+    EpochDomain(const EpochDomain&) = delete;
+    EpochDomain& operator=(const EpochDomain&) = delete;
+
+    // Enters a read-side critical section for the lifetime of the guard.
+    ReadGuard Read() const { return ReadGuard(*this); }
+
+    // Blocks until every read-side critical section that was active when the
+    // call started has finished.
+    void Synchronize();
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> active[2] = {{0}, {0}};
+    };
+
+    static size_t ThreadSlot();
+    void WaitForReaders(unsigned epoch) const;
+
+    mutable Slot slots_[SLOT_COUNT];
+    std::atomic<unsigned> epoch_{0};
+    std::mutex sync_mutex_;
+};
+
+} // namespace consistent
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <string>
+#include <string_view>
 #include <vector>
 #include <memory>
 #include <mutex>
@@ -12,39 +15,111 @@ public:
     virtual ~Hasher() = default;
     virtual uint64_t Sum64(const std::vector<uint8_t>& data) const = 0;
     virtual uint64_t Sum64(const std::string& data) const = 0;
+
+    // Hashes a raw byte range without requiring an owning container. The
+    // default copies into a vector; built-in hashers override it directly.
+    virtual uint64_t Sum64(const uint8_t* data, size_t length) const;
+
+    uint64_t Sum64(std::string_view data) const {
+        return Sum64(reinterpret_cast<const uint8_t*>(data.data()), data.size());
+    }
+    uint64_t Sum64(const char* data) const { return Sum64(std::string_view(data)); }
+
+    // Hashes keys[i] into out[i]. The default calls Sum64 per key; built-in
+    // hashers override it to run the whole batch without virtual dispatch.
+    virtual void Sum64Batch(const std::string* keys, size_t count, uint64_t* out) const;
+    virtual void Sum64Batch(const std::string_view* keys, size_t count, uint64_t* out) const;
 };
 
-// CRC64Hasher .
-class CRC64Hasher : public Hasher {
+// CRC64Hasher computes CRC-64/ISO using slicing-by-8 tables, or carry-less
+// multiply folding (PCLMULQDQ / PMULL) when the CPU supports it. Both paths
+// produce identical results; the fast path is picked once at startup.
+class CRC64Hasher final : public Hasher {
 private:
     static const uint64_t CRC64_ISO_POLY = 0xD800000000000000ULL;
-    static std::vector<uint64_t> crc64_table_;
     static std::once_flag table_init_flag_;
 
     static void InitializeTable();
     static uint64_t CalculateCRC64(const uint8_t* data, size_t length);
 
+    template <typename Key>
+    static void CalculateCRC64Batch(const Key* keys, size_t count, uint64_t* out);
+
 public:
     CRC64Hasher();
-    
+
+    // Whether the carry-less multiply path passed its self-test and is in use
+    static bool Accelerated();
+    // The slicing-by-8 result whatever the CPU supports, to check the fast path against
+    static uint64_t Sum64Table(const uint8_t* data, size_t length);
+
+    using Hasher::Sum64;
     uint64_t Sum64(const std::vector<uint8_t>& data) const override;
     uint64_t Sum64(const std::string& data) const override;
+    uint64_t Sum64(const uint8_t* data, size_t length) const override;
+    void Sum64Batch(const std::string* keys, size_t count, uint64_t* out) const override;
+    void Sum64Batch(const std::string_view* keys, size_t count, uint64_t* out) const override;
 };
 
 // FNVHasher .
-class FNVHasher : public Hasher {
+class FNVHasher final : public Hasher {
 private:
     static const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
     static const uint64_t FNV_PRIME = 1099511628211ULL;
 
+    static uint64_t CalculateFNV(const uint8_t* data, size_t length);
+
+    template <typename Key>
+    static void CalculateFNVBatch(const Key* keys, size_t count, uint64_t* out);
+
 public:
     FNVHasher() = default;
-    
+
+    using Hasher::Sum64;
+    uint64_t Sum64(const std::vector<uint8_t>& data) const override;
+    uint64_t Sum64(const std::string& data) const override;
+    uint64_t Sum64(const uint8_t* data, size_t length) const override;
+    void Sum64Batch(const std::string* keys, size_t count, uint64_t* out) const override;
+    void Sum64Batch(const std::string_view* keys, size_t count, uint64_t* out) const override;
+};
+
+// XXH3Hasher implements XXH3-64 (xxHash 0.8), bit-compatible with XXH3_64bits
+// and XXH3_64bits_withSeed.
+class XXH3Hasher final : public Hasher {
+private:
+    uint64_t seed_;
+    uint8_t secret_[192];
+
+public:
+    explicit XXH3Hasher(uint64_t seed = 0);
+
+    using Hasher::Sum64;
+    uint64_t Sum64(const std::vector<uint8_t>& data) const override;
+    uint64_t Sum64(const std::string& data) const override;
+    uint64_t Sum64(const uint8_t* data, size_t length) const override;
+    void Sum64Batch(const std::string* keys, size_t count, uint64_t* out) const override;
+    void Sum64Batch(const std::string_view* keys, size_t count, uint64_t* out) const override;
+};
+
+// WyHasher implements wyhash final version 4 with the default secret.
+class WyHasher final : public Hasher {
+private:
+    uint64_t seed_;
+
+public:
+    explicit WyHasher(uint64_t seed = 0) : seed_(seed) {}
+
+    using Hasher::Sum64;
     uint64_t Sum64(const std::vector<uint8_t>& data) const override;
     uint64_t Sum64(const std::string& data) const override;
+    uint64_t Sum64(const uint8_t* data, size_t length) const override;
+    void Sum64Batch(const std::string* keys, size_t count, uint64_t* out) const override;
+    void Sum64Batch(const std::string_view* keys, size_t count, uint64_t* out) const override;
 };
 
 std::unique_ptr<Hasher> CreateCRC64Hasher();
 std::unique_ptr<Hasher> CreateFNVHasher();
+std::unique_ptr<Hasher> CreateXXH3Hasher(uint64_t seed = 0);
+std::unique_ptr<Hasher> CreateWyHasher(uint64_t seed = 0);
 
 } // namespace consistent
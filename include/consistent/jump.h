@@ -0,0 +1,70 @@
+#pragma once
+
+#include "consistent.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+namespace consistent {
+
+// Jump Consistent Hash (Lamping & Veach) over numbered shards. Member i is
+// shard i, lookups are O(log n) with no tables, and the engine keeps only the
+// member list. Adding a member moves 1/n of the keys to it; removing the last
+// member moves only its keys, while removing any other renumbers the shards
+// after it and moves theirs as well.
+//
+// The membership, lookup and GetClosestN surface matches Consistent, so
+// callers can switch engines without other changes. Shards stand in for
+// partitions in the reported moves: part_id is the shard number, and a shard
+// that no longer exists moves to null. Reads are lock-free in the same way.
+class JumpConsistent {
+private:
+    struct State {
+        std::vector<std::shared_ptr<Member>> members;
+    };
+
+    std::unique_ptr<Hasher> hasher_;
+    std::atomic<const State*> state_{nullptr};
+    mutable EpochDomain epoch_;
+    std::mutex write_mutex_;
+
+    void Publish(std::unique_ptr<State> next);
+    std::shared_ptr<Member> LocateHash(uint64_t hkey) const;
+    std::vector<std::shared_ptr<Member>> GetClosestNByHash(uint64_t hkey, int count) const;
+    static int GetClosestN(const State& state, uint64_t hkey, int count, Member** out);
+
+public:
+    JumpConsistent(const std::vector<std::shared_ptr<Member>>& members, std::unique_ptr<Hasher> hasher);
+    ~JumpConsistent();
+
+    JumpConsistent(const JumpConsistent&) = delete;
+    JumpConsistent& operator=(const JumpConsistent&) = delete;
+
+    // Returns the bucket in [0, buckets) for key
+    static int32_t JumpHash(uint64_t key, int32_t buckets);
+
+    // Add appends the member as the next shard; members already present are ignored
+    std::vector<PartitionMove> Add(std::shared_ptr<Member> member);
+    std::vector<PartitionMove> Remove(const Member& member);
+    std::vector<PartitionMove> RemoveByName(const std::string& name);
+
+    std::shared_ptr<Member> LocateKey(const std::vector<uint8_t>& key) const;
+    std::shared_ptr<Member> LocateKey(const std::string& key) const;
+    std::shared_ptr<Member> LocateKey(std::string_view key) const;
+    std::shared_ptr<Member> LocateKey(const char* key) const;
+    std::shared_ptr<Member> LocateKey(const uint8_t* data, size_t length) const;
+
+    // The key's shard and the shards after it, wrapping around
+    std::vector<std::shared_ptr<Member>> GetClosestN(const std::vector<uint8_t>& key, int count) const;
+    std::vector<std::shared_ptr<Member>> GetClosestN(const std::string& key, int count) const;
+    std::vector<std::shared_ptr<Member>> GetClosestN(std::string_view key, int count) const;
+    std::vector<std::shared_ptr<Member>> GetClosestN(const char* key, int count) const;
+    std::vector<std::shared_ptr<Member>> GetClosestN(const uint8_t* data, size_t length, int count) const;
+    int GetClosestN(std::string_view key, int count, Member** out) const;
+
+    std::vector<std::shared_ptr<Member>> GetMembers() const;
+};
+
+} // namespace consistent
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "consistent.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+namespace consistent {
+
+constexpr uint32_t DEFAULT_MAGLEV_TABLE_SIZE = 65537;
+
+// Maglev-style lookup table (Eisenbud et al., NSDI '16). Every member fills
+// table slots in the order of its own permutation of the table, taking turns,
+// so each member owns within one slot of table_size / n entries. A lookup is
+// a hash and a single indexed load. Membership changes rebuild the table and
+// move slightly more keys than a ring would.
+//
+// Members are ordered by name before the table is built, so the placement
+// does not depend on the order of membership changes. The membership, lookup
+// and GetClosestN surface, and the lock-free reads, match Consistent; table
+// entries stand in for partitions in the reported moves.
+class MaglevConsistent {
+private:
+    struct State {
+        std::vector<std::shared_ptr<Member>> members;
+        std::vector<uint32_t> table;
+    };
+
+    std::unique_ptr<Hasher> hasher_;
+    uint32_t table_size_;
+    std::atomic<const State*> state_{nullptr};
+    mutable EpochDomain epoch_;
+    std::mutex write_mutex_;
+
+    void Publish(std::unique_ptr<State> next);
+    void Populate(State& state) const;
+    // Publishes next and returns the table entries whose member changed
+    std::vector<PartitionMove> Replace(const State& current, std::unique_ptr<State> next);
+    std::shared_ptr<Member> LocateHash(uint64_t hkey) const;
+    std::vector<std::shared_ptr<Member>> GetClosestNByHash(uint64_t hkey, int count) const;
+    int GetClosestN(const State& state, uint64_t hkey, int count, Member** out) const;
+
+public:
+    // table_size must be a prime no smaller than the member count
+    MaglevConsistent(const std::vector<std::shared_ptr<Member>>& members, std::unique_ptr<Hasher> hasher,
+                     uint32_t table_size = DEFAULT_MAGLEV_TABLE_SIZE);
+    ~MaglevConsistent();
+
+    MaglevConsistent(const MaglevConsistent&) = delete;
+    MaglevConsistent& operator=(const MaglevConsistent&) = delete;
+
+    std::vector<PartitionMove> Add(std::shared_ptr<Member> member);
+    std::vector<PartitionMove> Remove(const Member& member);
+    std::vector<PartitionMove> RemoveByName(const std::string& name);
+
+    std::shared_ptr<Member> LocateKey(const std::vector<uint8_t>& key) const;
+    std::shared_ptr<Member> LocateKey(const std::string& key) const;
+    std::shared_ptr<Member> LocateKey(std::string_view key) const;
+    std::shared_ptr<Member> LocateKey(const char* key) const;
+    std::shared_ptr<Member> LocateKey(const uint8_t* data, size_t length) const;
+
+    // The distinct members met walking the table onward from the key's entry
+    std::vector<std::shared_ptr<Member>> GetClosestN(const std::vector<uint8_t>& key, int count) const;
+    std::vector<std::shared_ptr<Member>> GetClosestN(const std::string& key, int count) const;
+    std::vector<std::shared_ptr<Member>> GetClosestN(std::string_view key, int count) const;
+    std::vector<std::shared_ptr<Member>> GetClosestN(const char* key, int count) const;
+    std::vector<std::shared_ptr<Member>> GetClosestN(const uint8_t* data, size_t length, int count) const;
+    int GetClosestN(std::string_view key, int count, Member** out) const;
+
+    std::vector<std::shared_ptr<Member>> GetMembers() const;
+    // Table entries owned by each member
+    std::unordered_map<std::string, double> LoadDistribution() const;
+};
+
+} // namespace consistent
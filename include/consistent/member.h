@@ -2,14 +2,32 @@
 
 #include <string>
 #include <memory>
+#include <mutex>
 
 namespace consistent {
 
 class Member : public std::enable_shared_from_this<Member> {
+private:
+    mutable std::once_flag cached_name_once_;
+    mutable std::string cached_name_;
+
 public:
+    Member() = default;
+    Member(const Member&) : std::enable_shared_from_this<Member>() {}
+    Member& operator=(const Member&) { return *this; }
     virtual ~Member() = default;
+
     virtual std::string String() const = 0;
     virtual std::unique_ptr<Member> Clone() const = 0;
+
+    // Name returns String() without building a new string on every call. The
+    // default computes it once on first use; members that already hold their
+    // canonical string should override it.
+    virtual const std::string& Name() const;
+
+    // Relative capacity. A member's virtual node count and load bound scale
+    // with its weight, so a weight 2 member takes twice the partitions.
+    virtual double Weight() const { return 1.0; }
 };
 
 // GatewayMember .
@@ -18,17 +36,22 @@ private:
     std::string id_;
     std::string host_;
     int port_;
+    double weight_;
+    std::string name_;
+    std::string address_;
 
 public:
-    GatewayMember(const std::string& id, const std::string& host, int port);
+    GatewayMember(const std::string& id, const std::string& host, int port, double weight = 1.0);
     
     std::string String() const override;
     std::unique_ptr<Member> Clone() const override;
+    const std::string& Name() const override;
+    double Weight() const override;
     
     const std::string& GetID() const;
     const std::string& GetHost() const;
     int GetPort() const;
-    std::string GetAddress() const;
+    const std::string& GetAddress() const;
 };
 
 } // namespace consistent
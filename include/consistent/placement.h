@@ -0,0 +1,205 @@
+#pragma once
+
+#include "arena.h"
+#include "pool.h"
+#include "ring.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// Placement building blocks shared by BasicConsistent and RingSet, so that
+// both derive the same virtual nodes, load bounds and partition owners from
+// the same members.
+
+namespace consistent {
+
+class Member;
+
+constexpr uint32_t NO_OWNER = UINT32_MAX;
+
+// Below this many partitions the threads cost more than they save
+constexpr uint64_t PARALLEL_MIN_PARTITIONS = 4096;
+
+// Runs fn(begin, end) over contiguous chunks of [0, count) on the threads of pool
+template <typename Fn>
+void ParallelFor(uint64_t count, WorkerPool& pool, Fn fn) {
+    if (pool.Threads() == 1 || count < PARALLEL_MIN_PARTITIONS) {
+        fn(uint64_t{0}, count);
+        return;
+    }
+    pool.Run(count, fn);
+}
+
+// Members by slot. Ring entries and partition owners are slot indices; a
+// member keeps its slot while it stays, and freed slots are cleared and taken
+// again by later additions.
+struct SlotTable {
+    std::vector<Member*> member_table;
+    std::vector<std::string> names;
+    std::vector<uint64_t> name_hashes;
+    std::vector<double> weights;
+
+    // Takes the first free slot, growing the table when there is none
+    uint32_t AcquireSlot(Member* member, const std::string& name, uint64_t name_hash, double weight);
+    // Clears member's slot and returns it, or NO_OWNER when it has none
+    uint32_t ReleaseSlot(Member* member);
+};
+
+// Throws std::invalid_argument unless weight is positive and finite
+void ValidateWeight(double weight);
+
+// replication_factor virtual nodes per unit of weight, at least one
+int VirtualNodeCount(int replication_factor, double weight);
+
+// Writes the key of name's index-th virtual node (the name followed by the
+// decimal index) into key
+void BuildVirtualNodeKey(const std::string& name, int index, std::vector<uint8_t>& key);
+
+template <typename HasherT>
+void InsertVirtualNodes(Ring& ring, const HasherT& hasher, const std::string& name, int count, uint32_t slot) {
+    std::vector<uint8_t> key;
+    for (int i = 0; i < count; ++i) {
+        BuildVirtualNodeKey(name, i, key);
+        ring.Insert(hasher.Sum64(key), slot);
+    }
+}
+
+// Throws std::invalid_argument when partition_count partitions at load
+// would put more than twice replication_factor on an average member, which
+// leaves the bounded-load walk too few virtual nodes to choose from
+void ValidateLoadBound(uint64_t partition_count, size_t member_count, double load, int replication_factor);
+
+// Partition count bound of every slot: its share of partition_count by
+// weight, times load. Free slots get 0. Rounded up when ceiled.
+ScratchVector<double> LoadCaps(const SlotTable& slots, uint64_t partition_count, double load, bool ceiled,
+                               std::pmr::memory_resource* scratch);
+
+// Bound on each slot's share of the recorded partition traffic, applied next
+// to the partition count bound. Inactive (empty) when there is no traffic.
+struct TrafficBound {
+    ScratchVector<double> traffic;  // By partition
+    ScratchVector<double> caps;     // By slot: weighted share of the total, times load
+    ScratchVector<double> assigned; // By slot: traffic of the partitions it owns
+
+    bool Active() const { return !caps.empty(); }
+    bool Fits(uint32_t slot, uint64_t part_id) const {
+        return !Active() || assigned[slot] + traffic[part_id] <= caps[slot];
+    }
+};
+
+// Partitions reassigned while one change is computed, recorded by the walks as
+// they place them. A partition is recorded when its owner slot changes, or
+// when it lands on a slot taken by a member added in this change (which may
+// have belonged to a removed member). It may appear more than once, or have
+// moved back by the end; the caller dedupes against the final owners.
+struct MoveLog {
+    const std::vector<uint32_t>* previous = nullptr; // Owner slots before the change; empty if there were none
+    const ScratchVector<bool>* fresh = nullptr;      // By slot: taken by a member added in this change
+    ScratchVector<uint32_t> parts;
+
+    void Record(uint64_t part_id, uint32_t slot) {
+        if (part_id >= previous->size() || (*previous)[part_id] != slot ||
+            (fresh && slot < fresh->size() && (*fresh)[slot])) {
+            parts.push_back(static_cast<uint32_t>(part_id));
+        }
+    }
+};
+
+// Partition IDs below partition_count in assignment order: ascending, or
+// heaviest first when bound is active so heavy partitions still find room
+ScratchVector<uint32_t> PartitionOrder(uint64_t partition_count, const TrafficBound& bound,
+                                       std::pmr::memory_resource* scratch);
+
+// Walks clockwise from ring position idx to the first slot other than skip
+// with room for part_id under caps and bound. When no slot has traffic room
+// the first one with partition room takes it. Adds the positions visited to
+// probes, and throws InsufficientSpaceException when no slot has room.
+uint32_t FindOwnerWithCapacity(const Ring& ring, const std::vector<uint32_t>& loads,
+                               const ScratchVector<double>& caps, const TrafficBound& bound, uint64_t part_id,
+                               size_t idx, uint32_t skip, uint64_t& probes);
+
+// Bounded-load assignment: every partition in order goes to
+// FindOwnerWithCapacity from its start position. Resets partitions, loads
+// and bound.assigned first, records each placement in log when given, and
+// returns the positions visited.
+uint64_t AssignPartitions(const Ring& ring, const ScratchVector<uint32_t>& starts,
+                          const ScratchVector<uint32_t>& order, const ScratchVector<double>& caps,
+                          TrafficBound& bound, std::vector<uint32_t>& partitions, std::vector<uint32_t>& loads,
+                          MoveLog* log);
+
+// Writes the first count distinct owners met walking clockwise from ring
+// position idx into out, as slots (uint32_t) or members (Member*), and
+// returns how many were found. Replica counts are small, so the owners found
+// so far double as the seen set.
+template <typename Out>
+int WalkClosestN(const Ring& ring, const std::vector<Member*>& member_table, size_t idx, int count, Out* out) {
+    size_t ring_size = ring.Size();
+    int found = 0;
+    for (size_t visited = 0; found < count && visited < ring_size; ++visited) {
+        Out value;
+        if constexpr (std::is_same_v<Out, uint32_t>) {
+            value = ring.Owner(idx);
+        } else {
+            value = member_table[ring.Owner(idx)];
+        }
+        if (std::find(out, out + found, value) == out + found) {
+            out[found++] = value;
+        }
+
+        idx++;
+        if (idx >= ring_size) {
+            idx = 0;
+        }
+    }
+    return found;
+}
+
+// Hash of each partition ID, the key its ring walk starts from. The IDs are
+// also kept sorted by hash, so the start positions of every partition take
+// one merge sweep against the sorted ring.
+class PartitionKeys {
+public:
+    // Hashes the partition IDs below count that are not hashed yet
+    template <typename HasherT>
+    void Grow(uint64_t count, const HasherT& hasher, WorkerPool& pool);
+
+    uint64_t Size() const { return keys_.size(); }
+    uint64_t operator[](uint64_t part_id) const { return keys_[part_id]; }
+
+    // Ring position each partition's walk starts from. Sweeps of separate
+    // chunks are independent, so they are split across the pool.
+    ScratchVector<uint32_t> FindStarts(const Ring& ring, WorkerPool& pool, std::pmr::memory_resource* scratch) const;
+
+private:
+    void Sort();
+
+    std::vector<uint64_t> keys_;
+    std::vector<uint32_t> order_;  // Partition IDs by ascending hash
+    std::vector<uint64_t> sorted_; // Their hashes in that order
+};
+
+template <typename HasherT>
+void PartitionKeys::Grow(uint64_t count, const HasherT& hasher, WorkerPool& pool) {
+    uint64_t first = keys_.size();
+    if (count <= first) {
+        return;
+    }
+
+    keys_.resize(count);
+    ParallelFor(count - first, pool, [&](uint64_t begin, uint64_t end) {
+        for (uint64_t part_id = first + begin; part_id < first + end; ++part_id) {
+            // Convert partition ID to bytes (little endian)
+            uint8_t bs[8];
+            for (int i = 0; i < 8; ++i) {
+                bs[i] = static_cast<uint8_t>((part_id >> (i * 8)) & 0xFF);
+            }
+            keys_[part_id] = hasher.Sum64(bs, sizeof(bs));
+        }
+    });
+    Sort();
+}
+
+} // namespace consistent
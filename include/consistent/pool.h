@@ -0,0 +1,52 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace consistent {
+
+// WorkerPool keeps threads - 1 workers parked for the lifetime of its owner,
+// so splitting a sweep across threads costs a wakeup instead of a thread
+// start and join per call. Run() hands each worker one chunk and runs the
+// first on the calling thread. Runs are serialized.
+class WorkerPool {
+public:
+    // threads <= 0 uses every hardware thread; 1 starts no workers
+    explicit WorkerPool(int threads = 1);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    int Threads() const { return threads_; }
+
+    // Runs fn(begin, end) over Threads() contiguous chunks of [0, count) and
+    // returns once all are done, rethrowing the first exception a chunk threw
+    void Run(uint64_t count, const std::function<void(uint64_t, uint64_t)>& fn);
+
+private:
+    void Work(int index);
+
+    int threads_;
+    std::vector<std::thread> workers_;
+    std::mutex run_mutex_;
+
+    // Current run, guarded by mutex_; generation_ tells workers a new one started
+    std::mutex mutex_;
+    std::condition_variable start_cv_;
+    std::condition_variable done_cv_;
+    const std::function<void(uint64_t, uint64_t)>* fn_ = nullptr;
+    uint64_t count_ = 0;
+    uint64_t chunk_ = 0;
+    uint64_t generation_ = 0;
+    int pending_ = 0;
+    std::exception_ptr error_;
+    bool stop_ = false;
+};
+
+} // namespace consistent
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+namespace consistent {
+
+// Ring holds the virtual nodes as one sorted array of hashes with the owner
+// slot of each entry alongside, so a lookup is a single search with no map
+// probe afterwards. Searches go through a small fence index holding the first
+// hash of every BLOCK_SIZE entries: a branchless binary search over the
+// fences, which stay in cache, picks the block and a linear count the
+// compiler can vectorize finishes inside it.
+//
+// With index_bits > 0 a jump table over the top index_bits of the hash is
+// used instead: it maps each bucket straight to its range of entries, which
+// makes a search near O(1) at the cost of 4 << index_bits bytes.
+class Ring {
+public:
+    static constexpr size_t BLOCK_SIZE = 16;
+    static constexpr unsigned MAX_INDEX_BITS = 24;
+
+    explicit Ring(unsigned index_bits = 0) : index_bits_(index_bits) {}
+
+    // Appends an entry. The ring is unsearchable until Build() is called.
+    void Insert(uint64_t hash, uint32_t owner);
+
+    // Drops every entry whose owner is flagged in removed (indexed by slot).
+    void RemoveOwners(const std::vector<bool>& removed);
+
+    // Sorts the entries and rebuilds the search index. When two entries share
+    // a hash, the one inserted last wins. Sort temporaries come from scratch;
+    // the ring's own arrays keep their capacity.
+    void Build(std::pmr::memory_resource* scratch = std::pmr::get_default_resource());
+
+    // Replaces the entries with already sorted, distinct hashes and rebuilds
+    // the search index. Returns false, leaving the ring unchanged, if the
+    // input is not strictly ascending.
+    bool Assign(std::vector<uint64_t> hashes, std::vector<uint32_t> owners);
+
+    // Index of the first entry whose hash is >= key, wrapping around to 0.
+    size_t FindStart(uint64_t key) const;
+
+    size_t Size() const { return hashes_.size(); }
+    bool Empty() const { return hashes_.empty(); }
+    uint64_t Hash(size_t idx) const { return hashes_[idx]; }
+    uint32_t Owner(size_t idx) const { return owners_[idx]; }
+    const std::vector<uint64_t>& Hashes() const { return hashes_; }
+    const std::vector<uint32_t>& Owners() const { return owners_; }
+
+private:
+    void BuildIndex();
+
+    std::vector<uint64_t> hashes_;
+    std::vector<uint32_t> owners_;
+    std::vector<uint64_t> fences_;
+    unsigned index_bits_;
+    std::vector<uint32_t> jump_;
+};
+
+} // namespace consistent
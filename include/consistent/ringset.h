@@ -0,0 +1,99 @@
+#pragma once
+
+#include "consistent.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace consistent {
+
+using TenantID = uint32_t;
+
+// RingSet serves many bounded-load rings ("tenants") over one pool of
+// members. The member table and the virtual-node ring are stored once and
+// shared; each tenant only adds its partition owners and loads, so memory
+// grows with tenants x partitions instead of tenants x members x
+// replication_factor. A membership change finds partition start positions
+// once for every tenant and redistributes all of them in one pass, then
+// publishes them together.
+//
+// Tenants differ in partition count and load. A tenant places partitions
+// exactly like a Consistent with the same hasher, replication factor,
+// partition count and load that saw the same membership changes (without
+// incremental_rebalance). Reads are lock-free as in Consistent.
+class RingSet {
+private:
+    struct Tenant {
+        uint64_t partition_count;
+        double load;
+        std::vector<uint32_t> partitions;
+        std::vector<uint32_t> loads;
+    };
+
+    struct State : SlotTable {
+        std::unordered_map<std::string, std::shared_ptr<Member>> members;
+        Ring ring;
+
+        // By tenant ID; null once removed. Unchanged tenants are shared between states.
+        std::vector<std::shared_ptr<const Tenant>> tenants;
+    };
+
+    std::unique_ptr<Hasher> hasher_;
+    int replication_factor_;
+
+    // Hash of each partition ID, shared by all tenants and grown to the
+    // largest partition count; writer-only
+    PartitionKeys partition_keys_;
+    WorkerPool distribution_pool_;
+
+    std::atomic<const State*> state_{nullptr};
+    mutable EpochDomain epoch_;
+    std::mutex write_mutex_;
+    mutable ScratchArena scratch_;
+
+    void Publish(std::unique_ptr<State> next);
+    void AddMember(State& state, std::shared_ptr<Member> member);
+
+    // Ring position of every partition ID hashed so far, at least partition_count
+    ScratchVector<uint32_t> FindStartIndices(const State& state, uint64_t partition_count);
+    std::shared_ptr<const Tenant> Distribute(const State& state, uint64_t partition_count, double load,
+                                             const ScratchVector<uint32_t>& starts, bool ceiled) const;
+    void RedistributeAll(State& state);
+
+    static const Tenant& GetTenant(const State& state, TenantID tenant);
+    std::shared_ptr<Member> LocateHash(TenantID tenant, uint64_t hkey) const;
+
+public:
+    // distribution_threads splits the start position sweep as Config::distribution_threads does
+    RingSet(const std::vector<std::shared_ptr<Member>>& members, std::unique_ptr<Hasher> hasher,
+            int replication_factor = DEFAULT_REPLICATION_FACTOR, int distribution_threads = 1);
+    ~RingSet();
+
+    RingSet(const RingSet&) = delete;
+    RingSet& operator=(const RingSet&) = delete;
+
+    // Tenant IDs are never reused; unknown or removed IDs raise std::out_of_range
+    TenantID AddTenant(int partition_count = DEFAULT_PARTITION_COUNT, double load = DEFAULT_LOAD);
+    void RemoveTenant(TenantID tenant);
+    size_t TenantCount() const;
+
+    // Membership changes apply to every tenant. Members already present and
+    // unknown names are skipped.
+    void Add(std::shared_ptr<Member> member);
+    void Remove(const Member& member);
+    void RemoveByName(const std::string& name);
+    void ApplyChanges(const std::vector<std::shared_ptr<Member>>& adds, const std::vector<std::string>& removes);
+
+    std::shared_ptr<Member> LocateKey(TenantID tenant, std::string_view key) const;
+    std::shared_ptr<Member> LocateKey(TenantID tenant, const uint8_t* data, size_t length) const;
+    std::vector<std::shared_ptr<Member>> GetClosestN(TenantID tenant, std::string_view key, int count) const;
+
+    std::vector<std::shared_ptr<Member>> GetMembers() const;
+    // Partitions of tenant owned by every member, 0 for one that owns none
+    std::unordered_map<std::string, double> LoadDistribution(TenantID tenant) const;
+};
+
+} // namespace consistent
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace consistent {
+
+// HotKeySketch is a Count-Min sketch over key hashes for spotting heavy
+// hitters. Counters are relaxed atomics, so recording from many threads is
+// lock-free and only approximately ordered, which the estimate tolerates.
+// Only one in SAMPLE_INTERVAL recordings touches the counters, picked from
+// the key hash mixed with a per-thread tick; the total is sampled alike, so
+// a key's share of events is unchanged while shared cache lines are written
+// that much less often. Once the sketch has sampled DECAY_FACTOR * width
+// events every counter is halved, so keys that cool down stop being hot.
+class HotKeySketch {
+public:
+    static constexpr size_t DEPTH = 4;
+    static constexpr uint64_t DECAY_FACTOR = 16;
+    static constexpr uint64_t SAMPLE_INTERVAL = 16; // Power of two
+
+    explicit HotKeySketch(size_t width);
+
+    HotKeySketch(const HotKeySketch&) = delete;
+    HotKeySketch& operator=(const HotKeySketch&) = delete;
+
+    // Counts one occurrence of hash and reports whether its estimated share
+    // of recent events is at least threshold
+    bool Record(uint64_t hash, double threshold);
+
+    // Counts one occurrence of hash without estimating it
+    void Count(uint64_t hash);
+
+    // Same estimate as Record without counting the event
+    bool IsHot(uint64_t hash, double threshold) const;
+
+private:
+    size_t Index(uint64_t hash, size_t row) const;
+    static bool Sampled(uint64_t hash);
+    // Adds a sampled event; returns the estimate for hash and sets total
+    uint64_t Add(uint64_t hash, uint64_t& total);
+    bool IsHot(uint64_t estimate, uint64_t total, double threshold) const;
+    void Decay(uint64_t total);
+
+    size_t width_;
+    std::unique_ptr<std::atomic<uint32_t>[]> counters_;
+    std::atomic<uint64_t> total_{0};
+};
+
+} // namespace consistent
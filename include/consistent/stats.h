@@ -0,0 +1,188 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+// Instrumentation is compiled in with -DCONSISTENT_ENABLE_STATS=1 (the
+// CONSISTENT_ENABLE_STATS CMake option). Without it StatsCollector is empty,
+// every call into it is an inline no-op and Stats() reports zeros.
+#ifndef CONSISTENT_ENABLE_STATS
+#define CONSISTENT_ENABLE_STATS 0
+#endif
+
+namespace consistent {
+
+constexpr size_t STATS_HISTOGRAM_BUCKETS = 40;
+
+// Every this many lookups per thread, one is timed for the latency histogram
+constexpr uint32_t LOOKUP_SAMPLE_INTERVAL = 64;
+
+// Log2 histogram of durations: bucket i counts samples in [2^i, 2^(i+1)) ns,
+// bucket 0 also those under 1 ns and the last bucket everything above.
+struct LatencyHistogram {
+    std::array<uint64_t, STATS_HISTOGRAM_BUCKETS> buckets{};
+
+    uint64_t Count() const;
+
+    // Upper bound in ns of the bucket holding quantile q (0 to 1); 0 when empty
+    uint64_t Percentile(double q) const;
+
+    static size_t Bucket(uint64_t ns);
+};
+
+// Totals since the ring was created
+struct RingStats {
+    uint64_t lookups = 0;
+    uint64_t closest_n_calls = 0;
+
+    // Membership changes, load rebalances and applied deltas that published a new ring
+    uint64_t rebalances = 0;
+    uint64_t rebalance_ns = 0;
+    uint64_t partitions_moved = 0;
+
+    // Time writers spent waiting for the writer lock
+    uint64_t lock_wait_ns = 0;
+
+    // Ring positions visited while looking for a member under its load bound
+    uint64_t load_probes = 0;
+
+    bool rebalance_in_progress = false;
+
+    LatencyHistogram lookup_latency; // Sampled, see LOOKUP_SAMPLE_INTERVAL
+    LatencyHistogram rebalance_latency;
+};
+
+// One published change, as reported to a StatsSink
+struct RebalanceEvent {
+    uint64_t epoch = 0;
+    uint64_t lock_wait_ns = 0;
+    uint64_t duration_ns = 0;
+    uint64_t partitions_moved = 0;
+    uint64_t load_probes = 0;
+};
+
+// Called after each published change, with the writer lock still held
+using StatsSink = std::function<void(const RebalanceEvent&)>;
+
+#if CONSISTENT_ENABLE_STATS
+
+// Lookup counters are sharded over cacheline-aligned slots, one per hardware
+// thread (rounded up to a power of two). Each thread takes the next slot the
+// first time it looks anything up, so up to that many concurrent readers
+// never write the same line. Writer-side figures are only touched under the
+// ring's writer lock.
+class StatsCollector {
+public:
+    StatsCollector();
+
+    static uint64_t Now() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                         std::chrono::steady_clock::now().time_since_epoch())
+                                         .count());
+    }
+
+    class LookupTimer {
+    public:
+        explicit LookupTimer(StatsCollector* stats) : stats_(stats), start_(stats ? Now() : 0) {}
+        LookupTimer(const LookupTimer&) = delete;
+        LookupTimer& operator=(const LookupTimer&) = delete;
+        ~LookupTimer() {
+            if (stats_) {
+                stats_->LocalShard().latency[LatencyHistogram::Bucket(Now() - start_)].fetch_add(
+                    1, std::memory_order_relaxed);
+            }
+        }
+
+    private:
+        StatsCollector* stats_;
+        uint64_t start_;
+    };
+
+    class RebalanceTimer {
+    public:
+        RebalanceTimer(StatsCollector& stats, uint64_t wait_start);
+        RebalanceTimer(const RebalanceTimer&) = delete;
+        RebalanceTimer& operator=(const RebalanceTimer&) = delete;
+        ~RebalanceTimer();
+
+        // Records a published change and reports it to sink
+        void Finish(uint64_t epoch, size_t moved, const StatsSink& sink);
+
+    private:
+        StatsCollector& stats_;
+        uint64_t lock_wait_ns_;
+        uint64_t start_;
+        uint64_t probes_at_start_;
+    };
+
+    // Counts a lookup and times it when it is sampled
+    LookupTimer Lookup() {
+        LocalShard().lookups.fetch_add(1, std::memory_order_relaxed);
+        thread_local uint32_t sample = 0;
+        return LookupTimer(++sample % LOOKUP_SAMPLE_INTERVAL == 0 ? this : nullptr);
+    }
+
+    void CountLookups(uint64_t count) { LocalShard().lookups.fetch_add(count, std::memory_order_relaxed); }
+    void CountClosestN() { LocalShard().closest_n_calls.fetch_add(1, std::memory_order_relaxed); }
+    void CountLoadProbes(uint64_t count) { load_probes_.fetch_add(count, std::memory_order_relaxed); }
+
+    // Call right after taking the writer lock; wait_start is Now() from before it
+    RebalanceTimer Rebalance(uint64_t wait_start) { return RebalanceTimer(*this, wait_start); }
+
+    RingStats Snapshot() const;
+
+private:
+    struct alignas(64) Shard {
+        std::atomic<uint64_t> lookups{0};
+        std::atomic<uint64_t> closest_n_calls{0};
+        std::array<std::atomic<uint64_t>, STATS_HISTOGRAM_BUCKETS> latency{};
+    };
+
+    Shard& LocalShard() { return shards_[ThreadIndex() & shard_mask_]; }
+    // Distinct per thread, assigned in the order threads first ask for it
+    static size_t ThreadIndex();
+
+    std::unique_ptr<Shard[]> shards_;
+    size_t shard_count_;
+    size_t shard_mask_;
+    std::atomic<uint64_t> rebalances_{0};
+    std::atomic<uint64_t> rebalance_ns_{0};
+    std::atomic<uint64_t> partitions_moved_{0};
+    std::atomic<uint64_t> lock_wait_ns_{0};
+    std::atomic<uint64_t> load_probes_{0};
+    std::atomic<bool> rebalance_in_progress_{false};
+    std::array<std::atomic<uint64_t>, STATS_HISTOGRAM_BUCKETS> rebalance_latency_{};
+};
+
+#else
+
+class StatsCollector {
+public:
+    static constexpr uint64_t Now() { return 0; }
+
+    // Non-trivial destructors keep unused-variable warnings off the call sites
+    struct LookupTimer {
+        ~LookupTimer() {}
+    };
+
+    struct RebalanceTimer {
+        ~RebalanceTimer() {}
+        void Finish(uint64_t, size_t, const StatsSink&) {}
+    };
+
+    LookupTimer Lookup() { return {}; }
+    void CountLookups(uint64_t) {}
+    void CountClosestN() {}
+    void CountLoadProbes(uint64_t) {}
+    RebalanceTimer Rebalance(uint64_t) { return {}; }
+    RingStats Snapshot() const { return {}; }
+};
+
+#endif
+
+} // namespace consistent
@@ -0,0 +1,50 @@
+#include "arena.h"
+#include <new>
+
+namespace consistent {
+
+ScratchArena::ScratchArena(size_t initial_size)
+    : block_(std::make_unique<std::byte[]>(initial_size)), size_(initial_size) {}
+
+ScratchArena::~ScratchArena() {
+    ReleaseOverflow();
+}
+
+void ScratchArena::Reset() {
+    used_ = 0;
+    if (overflow_.empty()) {
+        return;
+    }
+
+    // Grow to fit everything the last round needed in one block
+    size_t size = size_ + overflow_bytes_;
+    ReleaseOverflow();
+    block_ = std::make_unique<std::byte[]>(size);
+    size_ = size;
+}
+
+void* ScratchArena::do_allocate(size_t bytes, size_t alignment) {
+    // The block comes from new[], which aligns to max_align_t
+    if (alignment <= alignof(std::max_align_t)) {
+        size_t offset = (used_ + alignment - 1) & ~(alignment - 1);
+        if (offset <= size_ && bytes <= size_ - offset) {
+            used_ = offset + bytes;
+            return block_.get() + offset;
+        }
+    }
+
+    void* data = ::operator new(bytes, std::align_val_t(alignment));
+    overflow_.push_back({data, bytes, alignment});
+    overflow_bytes_ += bytes + alignment;
+    return data;
+}
+
+void ScratchArena::ReleaseOverflow() {
+    for (const auto& overflow : overflow_) {
+        ::operator delete(overflow.data, overflow.size, std::align_val_t(overflow.alignment));
+    }
+    overflow_.clear();
+    overflow_bytes_ = 0;
+}
+
+} // namespace consistent
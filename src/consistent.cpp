@@ -2,554 +2,1064 @@
 #include <algorithm>
 #include <sstream>
 #include <cmath>
+#include <numeric>
 #include <random>
+#include <thread>
+#include <type_traits>
 
 namespace consistent {
 
-Consistent::Consistent(const std::vector<std::shared_ptr<Member>>& members, Config config)
-    : config_(std::move(config)), partition_count_(config_.partition_count) {
+template <typename HasherT>
+BasicConsistent<HasherT>::BasicConsistent(const std::vector<std::shared_ptr<Member>>& members, Config config)
+    : config_(std::move(config)), partition_count_(config_.partition_count),
+      distribution_pool_(config_.distribution_threads) {
+
+    if constexpr (!std::is_same_v<HasherT, Hasher>) {
+        // A concrete hasher type can be defaulted rather than passed in
+        if (!config_.hasher) {
+            config_.hasher = std::make_unique<HasherT>();
+        }
+    }
 
     // Validate configuration
     ValidateConfig(members.size(), config_);
 
+    hasher_ = dynamic_cast<const HasherT*>(config_.hasher.get());
+    if (!hasher_) {
+        throw std::invalid_argument("hasher does not match the BasicConsistent hasher type");
+    }
+
+    partition_traffic_.assign(partition_count_, 0.0);
+    if (config_.hot_key_sketch_width > 0) {
+        sketch_ = std::make_unique<HotKeySketch>(config_.hot_key_sketch_width);
+    }
+
+    // Partition hashes never change, so compute them once
+    partition_keys_.Grow(partition_count_, *hasher_, distribution_pool_);
+
+    auto state = std::make_unique<State>();
+    state->ring = Ring(static_cast<unsigned>(config_.ring_index_bits));
+
     // Initialize members
     for (const auto& member : members) {
-        InitMember(member);
+        InitMember(*state, member);
     }
 
+    // Sort the hash values in ascending order
+    state->ring.Build(&scratch_);
+
     if (!members.empty()) {
-        DistributePartitions();
+        DistributePartitions(*state);
+    }
+
+    RefreshReplicas(*state);
+    RefreshMemberView(*state);
+    state_.store(state.release(), std::memory_order_release);
+}
+
+template <typename HasherT>
+BasicConsistent<HasherT>::~BasicConsistent() {
+    {
+        std::lock_guard<std::mutex> lock(change_queue_mutex_);
+        stop_change_worker_ = true;
+    }
+    change_queue_cv_.notify_all();
+    if (change_worker_.joinable()) {
+        change_worker_.join();
     }
+    delete state_.load(std::memory_order_acquire);
+}
+
+template <typename HasherT>
+void BasicConsistent<HasherT>::Publish(std::unique_ptr<State> next) {
+    RefreshMemberView(*next);
+    const State* old = state_.exchange(next.release(), std::memory_order_seq_cst);
+
+    // Wait until no reader can still be looking at the old state
+    epoch_.Synchronize();
+
+    ParkState(std::unique_ptr<State>(const_cast<State*>(old)));
 }
 
-void Consistent::ValidateConfig(int member_count, const Config& config) {
+template <typename HasherT>
+typename BasicConsistent<HasherT>::Draft BasicConsistent<HasherT>::NextState(const State& current) {
+    if (!spare_state_) {
+        return Draft(*this, std::make_unique<State>(current));
+    }
+    auto next = std::move(spare_state_);
+    *next = current;
+    return Draft(*this, std::move(next));
+}
+
+template <typename HasherT>
+void BasicConsistent<HasherT>::ParkState(std::unique_ptr<State> state) {
+    // Keep its storage for the next change, but not its members
+    for (auto& [name, member] : state->members) {
+        member.reset();
+    }
+    state->view.reset();
+    spare_state_ = std::move(state);
+}
+
+template <typename HasherT>
+void BasicConsistent<HasherT>::ValidateConfig(int member_count, const Config& config) {
     if (!config.hasher) {
         throw std::invalid_argument("hasher cannot be null");
     }
-    if (member_count == 0) {
-        return; // Empty ring is valid
+    if (config.ring_index_bits < 0 || config.ring_index_bits > static_cast<int>(Ring::MAX_INDEX_BITS)) {
+        throw std::invalid_argument("ring_index_bits must be between 0 and 24");
+    }
+    if (config.hot_key_replicas < 1 || config.hot_key_replicas > MAX_HOT_KEY_REPLICAS) {
+        throw std::invalid_argument("hot_key_replicas must be between 1 and 16");
     }
-    
-    double avg_load = static_cast<double>(config.partition_count) / member_count * config.load;
-    double max_load = std::ceil(avg_load);
-    
-    if (max_load > config.replication_factor * 2.0) {
-        std::ostringstream oss;
-        oss << "configuration may cause distribution issues: partitionCount=" 
-            << config.partition_count << ", memberCount=" << member_count 
-            << ", load=" << config.load << " results in avgLoad=" << max_load << " per member";
-        throw std::invalid_argument(oss.str());
+    if (config.precompute_replicas < 0) {
+        throw std::invalid_argument("precompute_replicas cannot be negative");
     }
+    ValidateLoadBound(config.partition_count, member_count, config.load, config.replication_factor);
 }
 
-void Consistent::Add(std::shared_ptr<Member> member) {
-    std::string member_name = member->String();
+template <typename HasherT>
+std::vector<PartitionMove> BasicConsistent<HasherT>::Add(std::shared_ptr<Member> member) {
+    return ApplyChanges({std::move(member)}, {});
+}
 
-    // First check if the member already exists (read lock)
+template <typename HasherT>
+std::vector<PartitionMove> BasicConsistent<HasherT>::AddMany(const std::vector<std::shared_ptr<Member>>& members) {
+    return ApplyChanges(members, {});
+}
+
+template <typename HasherT>
+std::vector<PartitionMove> BasicConsistent<HasherT>::Remove(const Member& member) {
+    return RemoveByName(member.Name());
+}
+
+template <typename HasherT>
+std::vector<PartitionMove> BasicConsistent<HasherT>::RemoveByName(const std::string& name) {
+    return ApplyChanges({}, {name});
+}
+
+template <typename HasherT>
+std::vector<PartitionMove> BasicConsistent<HasherT>::RemoveMany(const std::vector<std::string>& names) {
+    return ApplyChanges({}, names);
+}
+
+template <typename HasherT>
+std::future<std::vector<PartitionMove>> BasicConsistent<HasherT>::AddAsync(std::shared_ptr<Member> member) {
+    if (!member) {
+        throw std::invalid_argument("member cannot be null");
+    }
+    return EnqueueChange({std::move(member), {}, {}});
+}
+
+template <typename HasherT>
+std::future<std::vector<PartitionMove>> BasicConsistent<HasherT>::RemoveAsync(const std::string& name) {
+    return EnqueueChange({nullptr, name, {}});
+}
+
+template <typename HasherT>
+std::future<std::vector<PartitionMove>> BasicConsistent<HasherT>::EnqueueChange(QueuedChange change) {
+    auto done = change.done.get_future();
     {
-        std::shared_lock<std::shared_mutex> lock(mutex_);
-        if (members_.find(member_name) != members_.end()) {
-            return; // Member already exists
+        std::lock_guard<std::mutex> lock(change_queue_mutex_);
+        change_queue_.push_back(std::move(change));
+        if (!change_worker_.joinable()) {
+            change_worker_ = std::thread(&BasicConsistent::RunChangeWorker, this);
         }
     }
+    change_queue_cv_.notify_one();
+    return done;
+}
 
-    // Acquire write lock to update data structures
-    std::unique_lock<std::shared_mutex> lock(mutex_);
+template <typename HasherT>
+void BasicConsistent<HasherT>::RunChangeWorker() {
+    for (;;) {
+        std::deque<QueuedChange> batch;
+        {
+            std::unique_lock<std::mutex> lock(change_queue_mutex_);
+            change_queue_cv_.wait(lock, [this] { return stop_change_worker_ || !change_queue_.empty(); });
+            if (change_queue_.empty()) {
+                return; // Stopping, and everything queued has been applied
+            }
+            batch.swap(change_queue_);
+        }
 
-    // Double-check if member exists
-    if (members_.find(member_name) != members_.end()) {
-        return;
-    }
+        // ApplyChanges runs removes before adds, so a run ends before the
+        // first name it already touches to keep the queued order
+        for (size_t begin = 0; begin < batch.size();) {
+            std::vector<std::shared_ptr<Member>> adds;
+            std::vector<std::string> removes;
+            std::unordered_set<std::string_view> touched;
+
+            size_t end = begin;
+            for (; end < batch.size(); ++end) {
+                const auto& change = batch[end];
+                if (!touched.insert(change.add ? change.add->Name() : change.remove).second) {
+                    break;
+                }
+                if (change.add) {
+                    adds.push_back(change.add);
+                } else {
+                    removes.push_back(change.remove);
+                }
+            }
 
-    members_[member_name] = member;
+            try {
+                auto moves = ApplyChanges(adds, removes);
+                for (size_t i = begin; i < end; ++i) {
+                    batch[i].done.set_value(moves);
+                }
+            } catch (...) {
+                for (size_t i = begin; i < end; ++i) {
+                    batch[i].done.set_exception(std::current_exception());
+                }
+            }
+            begin = end;
+        }
+    }
+}
 
-    // Add to ring
-    AddToRing(member);
+template <typename HasherT>
+std::vector<PartitionMove> BasicConsistent<HasherT>::ApplyChanges(
+    const std::vector<std::shared_ptr<Member>>& adds, const std::vector<std::string>& removes) {
+
+    // Writers are serialized; readers keep using the published state meanwhile
+    uint64_t wait_start = StatsCollector::Now();
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    auto rebalance = stats_.Rebalance(wait_start);
+    scratch_.Reset();
+    const State* current = state_.load(std::memory_order_acquire);
+
+    // Build the next state off to the side
+    auto next = NextState(*current);
+    std::vector<Member*> added;
+    std::vector<Member*> removed;
+
+    next->epoch = current->epoch + 1;
+    std::vector<std::string> removed_names;
+    std::vector<uint32_t> added_slots;
+
+    std::vector<bool> removed_slots(next->member_table.size(), false);
+    for (const auto& name : removes) {
+        auto existing = next->members.find(name);
+        if (existing == next->members.end()) {
+            continue; // Member doesn't exist
+        }
+        if (config_.on_ring_delta) {
+            removed_names.push_back(name);
+        }
 
-    // Calculate new partition distribution (now that member is in members_)
-    auto [new_partitions, new_loads] = CalculatePartitionsWithNewMember(member_name);
+        // Remove all references to the member before dropping ownership of it.
+        // Readers of the old state keep it alive until they are done.
+        removed.push_back(existing->second.get());
+        removed_slots[ReleaseSlot(*next, existing->second.get())] = true;
+        next->members.erase(existing);
+    }
+    if (!removed.empty()) {
+        next->ring.RemoveOwners(removed_slots);
+    }
 
-    partitions_ = std::move(new_partitions);
-    loads_ = std::move(new_loads);
-    members_dirty_ = true;
-}
+    for (const auto& member : adds) {
+        const std::string& member_name = member->Name();
+        if (next->members.find(member_name) != next->members.end()) {
+            continue; // Member already exists
+        }
 
-std::pair<std::unordered_map<int, Member*>, std::unordered_map<std::string, double>>
-Consistent::CalculatePartitionsWithNewMember(const std::string& member_name) {
-    std::shared_lock<std::shared_mutex> lock(mutex_);
+        next->members[member_name] = member;
+        added.push_back(member.get());
+        added_slots.push_back(AddToRing(*next, member, member_name));
+    }
+    if (added.empty() && removed.empty()) {
+        return {};
+    }
+    next->ring.Build(&scratch_);
 
-    auto it = members_.find(member_name);
-    if (it == members_.end()) {
-        // Member not found, return current state
-        return {partitions_, loads_};
+    // The walks below record what they reassign
+    ScratchVector<bool> fresh(next->member_table.size(), false, &scratch_);
+    for (uint32_t slot : added_slots) {
+        fresh[slot] = true;
     }
+    MoveLog log{&current->partitions, &fresh, ScratchVector<uint32_t>(&scratch_)};
+
+    // Calculate new partition distribution once for the whole change set
+    if (next->members.empty()) {
+        // Last member being removed; every partition loses its owner
+        for (uint64_t part_id = 0; part_id < current->partitions.size(); ++part_id) {
+            if (current->partitions[part_id] != NO_OWNER) {
+                log.parts.push_back(static_cast<uint32_t>(part_id));
+            }
+        }
+        next->partitions.clear();
+    } else {
+        TrafficBound bound = RecordedTraffic(*next);
+        if (config_.incremental_rebalance && !current->members.empty()) {
+            RebalanceIncrementally(*current, *next, added, removed, bound, log);
+        } else {
+            CalculatePartitionsWithRingAndMemberCount(*next, next->members.size(), bound, &log);
+        }
 
-    Member* new_member = it->second.get();
+        // Walks bounded by partition count alone can leave members above their traffic bound
+        ShedTraffic(*next, bound, log);
+    }
+    std::vector<PartitionMove> moves = CollectMoves(*current, *next, log);
 
-    // Create temporary ring and sorted set
-    std::unordered_map<uint64_t, Member*> temp_ring = ring_;
-    std::vector<uint64_t> temp_sorted_set = sorted_set_;
+    RefreshReplicas(*next);
 
-    // Add new member to temporary ring
-    for (int i = 0; i < config_.replication_factor; ++i) {
-        auto key = BuildVirtualNodeKey(member_name, i);
-        uint64_t h = config_.hasher->Sum64(key);
-        temp_ring[h] = new_member;
-        temp_sorted_set.push_back(h);
+    std::vector<uint8_t> delta;
+    if (config_.on_ring_delta) {
+        delta = EncodeDelta(*current, *next, removed_names, added_slots, log);
     }
+    uint64_t epoch = next->epoch;
+    Publish(next.Release());
+    NotifyMoves(moves);
+    NotifyDelta(epoch, delta);
+    rebalance.Finish(epoch, moves.size(), config_.stats_sink);
+    return moves;
+}
 
-    // Sort the temporary set
-    std::sort(temp_sorted_set.begin(), temp_sorted_set.end());
+template <typename HasherT>
+uint32_t BasicConsistent<HasherT>::AddToRing(State& state, std::shared_ptr<Member> member, const std::string& name) {
+    double weight = member->Weight();
+    ValidateWeight(weight);
 
-    int new_member_count = members_.size();
-    return CalculatePartitionsWithRingAndMemberCount(temp_ring, temp_sorted_set, new_member_count);
+    // Callers rebuild state.ring once they are done adding
+    uint32_t slot = AcquireSlot(state, member.get(), name);
+    InsertVirtualNodes(state.ring, *hasher_, name, VirtualNodeCount(config_.replication_factor, weight), slot);
+    return slot;
 }
 
-void Consistent::AddToRing(std::shared_ptr<Member> member) {
-    Member* raw_ptr = member.get();
-    for (int i = 0; i < config_.replication_factor; ++i) {
-        auto key = BuildVirtualNodeKey(member->String(), i);
-        uint64_t h = config_.hasher->Sum64(key);
-        ring_[h] = raw_ptr;  // Store raw pointer for performance
-        sorted_set_.push_back(h);
-    }
-    std::sort(sorted_set_.begin(), sorted_set_.end());
+template <typename HasherT>
+uint32_t BasicConsistent<HasherT>::AcquireSlot(State& state, Member* member, const std::string& name) const {
+    uint32_t slot = state.AcquireSlot(member, name, hasher_->Sum64(name), member->Weight());
+    state.loads.resize(state.member_table.size(), 0);
+    state.loads[slot] = 0;
+    return slot;
 }
 
-void Consistent::Remove(const Member& member) {
-    RemoveByName(member.String());
+template <typename HasherT>
+uint32_t BasicConsistent<HasherT>::ReleaseSlot(State& state, Member* member) {
+    uint32_t slot = state.ReleaseSlot(member);
+    if (slot != NO_OWNER) {
+        state.loads[slot] = 0;
+    }
+    return slot;
 }
 
-void Consistent::RemoveByName(const std::string& name) {
-    // First check if member exists (read lock)
-    {
-        std::shared_lock<std::shared_mutex> lock(mutex_);
-        if (members_.find(name) == members_.end()) {
-            return; // Member doesn't exist
+template <typename HasherT>
+void BasicConsistent<HasherT>::RefreshMemberView(State& state) {
+    auto view = std::make_shared<MemberView>();
+    view->epoch = state.epoch;
+    view->members.reserve(state.members.size());
+    view->loads.reserve(state.members.size());
+    for (size_t slot = 0; slot < state.member_table.size(); ++slot) {
+        if (state.member_table[slot]) {
+            view->members.push_back(state.members.at(state.names[slot]));
+            view->loads.emplace(state.names[slot], state.loads[slot]);
         }
     }
+    state.view = std::move(view);
+}
 
-    // Calculate new partition distribution
-    auto [new_partitions, new_loads] = CalculatePartitionsWithoutMember(name);
+template <typename HasherT>
+std::shared_ptr<Member> BasicConsistent<HasherT>::LocateKey(const std::vector<uint8_t>& key) const {
+    auto timer = stats_.Lookup();
+    return LocateHash(hasher_->Sum64(key));
+}
 
-    // Acquire write lock to update data structures
-    std::unique_lock<std::shared_mutex> lock(mutex_);
+template <typename HasherT>
+std::shared_ptr<Member> BasicConsistent<HasherT>::LocateKey(const std::string& key) const {
+    auto timer = stats_.Lookup();
+    return LocateHash(hasher_->Sum64(key));
+}
 
-    // Double-check if member exists
-    if (members_.find(name) == members_.end()) {
-        return;
+template <typename HasherT>
+std::shared_ptr<Member> BasicConsistent<HasherT>::LocateKey(std::string_view key) const {
+    auto timer = stats_.Lookup();
+    return LocateHash(hasher_->Sum64(reinterpret_cast<const uint8_t*>(key.data()), key.size()));
+}
+
+template <typename HasherT>
+std::shared_ptr<Member> BasicConsistent<HasherT>::LocateKey(const char* key) const {
+    return LocateKey(std::string_view(key));
+}
+
+template <typename HasherT>
+std::shared_ptr<Member> BasicConsistent<HasherT>::LocateKey(const uint8_t* data, size_t length) const {
+    auto timer = stats_.Lookup();
+    return LocateHash(hasher_->Sum64(data, length));
+}
+
+template <typename HasherT>
+std::shared_ptr<Member> BasicConsistent<HasherT>::LocateHash(uint64_t hkey) const {
+    auto guard = epoch_.Read();
+    const State* state = state_.load(std::memory_order_seq_cst);
+
+    if (state->ring.Empty()) {
+        return nullptr;
     }
 
-    // CRITICAL: Remove all references to the member BEFORE deleting it
-    // This prevents dangling pointers in ring_ and partitions_
-    RemoveFromRing(name);
+    if (sketch_) {
+        sketch_->Count(hkey);
+    }
+    Member* raw_ptr = LocateOwner(*state, hkey);
 
-    // Update partitions and loads BEFORE erasing the member
-    if (members_.size() == 1) {
-        // Last member being removed
-        partitions_.clear();
-        loads_.clear();
-    } else {
-        partitions_ = std::move(new_partitions);
-        loads_ = std::move(new_loads);
-    }
-
-    // Finally, erase the member (this destroys the unique_ptr and frees memory)
-    members_.erase(name);
-    members_dirty_ = true;
-}
-
-std::pair<std::unordered_map<int, Member*>, std::unordered_map<std::string, double>>
-Consistent::CalculatePartitionsWithoutMember(const std::string& member_name) {
-    std::shared_lock<std::shared_mutex> lock(mutex_);
-    
-    // Pre-calculate hashes to delete
-    std::unordered_set<uint64_t> hashes_to_delete;
-    for (int i = 0; i < config_.replication_factor; ++i) {
-        auto key = BuildVirtualNodeKey(member_name, i);
-        uint64_t h = config_.hasher->Sum64(key);
-        hashes_to_delete.insert(h);
-    }
-    
-    // Create temporary ring and sorted set
-    std::unordered_map<uint64_t, Member*> temp_ring;
-    std::vector<uint64_t> temp_sorted_set;
-    
-    for (const auto& [hash, member] : ring_) {
-        if (hashes_to_delete.find(hash) == hashes_to_delete.end()) {
-            temp_ring[hash] = member;
-            temp_sorted_set.push_back(hash);
-        }
+    if (!raw_ptr) {
+        return nullptr;
     }
-    
-    std::sort(temp_sorted_set.begin(), temp_sorted_set.end());
-    
-    return CalculatePartitionsWithRingAndMemberCount(temp_ring, temp_sorted_set, members_.size() - 1);
+
+    return raw_ptr->shared_from_this();
+}
+
+template <typename HasherT>
+std::shared_ptr<Member> BasicConsistent<HasherT>::LocateKeyOnRing(std::string_view key) const {
+    auto timer = stats_.Lookup();
+    return LocateHashOnRing(hasher_->Sum64(reinterpret_cast<const uint8_t*>(key.data()), key.size()));
 }
 
-void Consistent::RemoveFromRing(const std::string& name) {
-    for (int i = 0; i < config_.replication_factor; ++i) {
-        auto key = BuildVirtualNodeKey(name, i);
-        uint64_t h = config_.hasher->Sum64(key);
-        ring_.erase(h);
-        DelSlice(h);
+template <typename HasherT>
+std::shared_ptr<Member> BasicConsistent<HasherT>::LocateKeyOnRing(const uint8_t* data, size_t length) const {
+    auto timer = stats_.Lookup();
+    return LocateHashOnRing(hasher_->Sum64(data, length));
+}
+
+template <typename HasherT>
+std::shared_ptr<Member> BasicConsistent<HasherT>::LocateHashOnRing(uint64_t hkey) const {
+    auto guard = epoch_.Read();
+    const State* state = state_.load(std::memory_order_seq_cst);
+
+    if (state->ring.Empty()) {
+        return nullptr;
     }
+    return state->member_table[state->ring.Owner(state->ring.FindStart(hkey))]->shared_from_this();
 }
 
-void Consistent::DelSlice(uint64_t val) {
-    auto it = std::lower_bound(sorted_set_.begin(), sorted_set_.end(), val);
+template <typename HasherT>
+std::shared_ptr<Member> BasicConsistent<HasherT>::LocateKeySpread(std::string_view key) const {
+    auto timer = stats_.Lookup();
+    return LocateHashSpread(hasher_->Sum64(reinterpret_cast<const uint8_t*>(key.data()), key.size()));
+}
+
+template <typename HasherT>
+std::shared_ptr<Member> BasicConsistent<HasherT>::LocateKeySpread(const uint8_t* data, size_t length) const {
+    auto timer = stats_.Lookup();
+    return LocateHashSpread(hasher_->Sum64(data, length));
+}
 
-    if (it != sorted_set_.end() && *it == val) {
-        sorted_set_.erase(it);
+template <typename HasherT>
+bool BasicConsistent<HasherT>::IsHotKey(std::string_view key) const {
+    if (!sketch_) {
+        return false;
     }
+    uint64_t hkey = hasher_->Sum64(reinterpret_cast<const uint8_t*>(key.data()), key.size());
+    return sketch_->IsHot(hkey, config_.hot_key_threshold);
 }
 
-std::shared_ptr<Member> Consistent::LocateKey(const std::vector<uint8_t>& key) const {
-    if (ring_.empty()) {
-        return nullptr;
+template <typename HasherT>
+std::shared_ptr<Member> BasicConsistent<HasherT>::LocateHashSpread(uint64_t hkey) const {
+    if (!sketch_ || !sketch_->Record(hkey, config_.hot_key_threshold)) {
+        auto guard = epoch_.Read();
+        const State* state = state_.load(std::memory_order_seq_cst);
+        Member* owner = state->ring.Empty() ? nullptr : LocateOwner(*state, hkey);
+        return owner ? owner->shared_from_this() : nullptr;
     }
 
-    std::shared_lock<std::shared_mutex> lock(mutex_);
-    int part_id = GetPartitionID(key);
-    Member* raw_ptr = GetPartitionOwner(part_id);
+    auto guard = epoch_.Read();
+    const State* state = state_.load(std::memory_order_seq_cst);
 
-    if (!raw_ptr) {
+    int part_id = GetPartitionID(hkey);
+    int count = std::min(config_.hot_key_replicas, static_cast<int>(state->members.size()));
+    if (count == 0 || !GetPartitionOwner(*state, part_id)) {
         return nullptr;
     }
 
-    return raw_ptr->shared_from_this();
+    uint32_t replicas[MAX_HOT_KEY_REPLICAS];
+    if (count <= state->replica_count) {
+        std::copy_n(state->replicas.data() + static_cast<size_t>(part_id) * state->replica_count, count, replicas);
+    } else {
+        count = WalkClosestN(*state, part_id, count, replicas);
+    }
+
+    // Power of two choices over the spread counters
+    thread_local uint64_t rng = 0x9E3779B97F4A7C15ULL ^ reinterpret_cast<uintptr_t>(&rng);
+    rng ^= rng << 13;
+    rng ^= rng >> 7;
+    rng ^= rng << 17;
+    int first = static_cast<int>(rng % count);
+    int second = count > 1 ? static_cast<int>((first + 1 + (rng >> 32) % (count - 1)) % count) : first;
+
+    auto counter = [&](uint32_t slot) -> std::atomic<uint64_t>& {
+        return spread_counts_[state->name_hashes[slot] % SPREAD_COUNTER_COUNT];
+    };
+    uint32_t chosen = counter(replicas[first]).load(std::memory_order_relaxed) <=
+                      counter(replicas[second]).load(std::memory_order_relaxed)
+                          ? replicas[first]
+                          : replicas[second];
+    counter(chosen).fetch_add(1, std::memory_order_relaxed);
+    return state->member_table[chosen]->shared_from_this();
 }
 
-std::shared_ptr<Member> Consistent::LocateKey(const std::string& key) const {
-    if (ring_.empty()) {
-        return nullptr;
+template <typename HasherT>
+Member* BasicConsistent<HasherT>::LocateOwner(const State& state, uint64_t hkey) const {
+    if (config_.lookup_mode == LookupMode::Ring) {
+        return state.member_table[state.ring.Owner(state.ring.FindStart(hkey))];
     }
+    return GetPartitionOwner(state, GetPartitionID(hkey));
+}
 
-    std::shared_lock<std::shared_mutex> lock(mutex_);
-    int part_id = GetPartitionID(key);
-    Member* raw_ptr = GetPartitionOwner(part_id);
+template <typename HasherT>
+void BasicConsistent<HasherT>::LocateKeys(const std::vector<std::string>& keys, std::vector<Member*>& out) const {
+    LocateKeysImpl(keys, out);
+}
 
-    if (!raw_ptr) {
-        return nullptr;
+template <typename HasherT>
+void BasicConsistent<HasherT>::LocateKeys(const std::vector<std::string_view>& keys, std::vector<Member*>& out) const {
+    LocateKeysImpl(keys, out);
+}
+
+template <typename HasherT>
+void BasicConsistent<HasherT>::LocatePartitionIDs(const std::vector<std::string>& keys, std::vector<int>& out) const {
+    LocatePartitionIDsImpl(keys, out);
+}
+
+template <typename HasherT>
+void BasicConsistent<HasherT>::LocatePartitionIDs(const std::vector<std::string_view>& keys, std::vector<int>& out) const {
+    LocatePartitionIDsImpl(keys, out);
+}
+
+template <typename HasherT>
+template <typename Key>
+void BasicConsistent<HasherT>::LocateKeysImpl(const std::vector<Key>& keys, std::vector<Member*>& out) const {
+    out.resize(keys.size());
+    stats_.CountLookups(keys.size());
+
+    auto guard = epoch_.Read();
+    const State* state = state_.load(std::memory_order_seq_cst);
+
+    if (state->ring.Empty()) {
+        std::fill(out.begin(), out.end(), nullptr);
+        return;
     }
 
-    return raw_ptr->shared_from_this();
+    uint64_t hashes[LOCATE_BATCH_SIZE];
+    for (size_t base = 0; base < keys.size(); base += LOCATE_BATCH_SIZE) {
+        size_t n = std::min(LOCATE_BATCH_SIZE, keys.size() - base);
+        hasher_->Sum64Batch(keys.data() + base, n, hashes);
+
+        for (size_t i = 0; i < n; ++i) {
+            out[base + i] = LocateOwner(*state, hashes[i]);
+        }
+    }
 }
 
-int Consistent::GetPartitionID(const std::vector<uint8_t>& key) const {
-    uint64_t hkey = config_.hasher->Sum64(key);
-    return static_cast<int>(hkey % partition_count_);
+template <typename HasherT>
+template <typename Key>
+void BasicConsistent<HasherT>::LocatePartitionIDsImpl(const std::vector<Key>& keys, std::vector<int>& out) const {
+    out.resize(keys.size());
+
+    uint64_t hashes[LOCATE_BATCH_SIZE];
+    for (size_t base = 0; base < keys.size(); base += LOCATE_BATCH_SIZE) {
+        size_t n = std::min(LOCATE_BATCH_SIZE, keys.size() - base);
+        hasher_->Sum64Batch(keys.data() + base, n, hashes);
+
+        for (size_t i = 0; i < n; ++i) {
+            out[base + i] = GetPartitionID(hashes[i]);
+        }
+    }
 }
 
-int Consistent::GetPartitionID(const std::string& key) const {
-    uint64_t hkey = config_.hasher->Sum64(key);
+template <typename HasherT>
+int BasicConsistent<HasherT>::GetPartitionID(uint64_t hkey) const {
     return static_cast<int>(hkey % partition_count_);
 }
 
-std::vector<std::shared_ptr<Member>> Consistent::GetClosestN(const std::vector<uint8_t>& key, int count) const {
+template <typename HasherT>
+std::vector<std::shared_ptr<Member>> BasicConsistent<HasherT>::GetClosestN(const std::vector<uint8_t>& key, int count) const {
     if (count <= 0) {
         return {};
     }
+    return GetClosestNByHash(hasher_->Sum64(key), count);
+}
 
-    std::shared_lock<std::shared_mutex> lock(mutex_);
+template <typename HasherT>
+std::vector<std::shared_ptr<Member>> BasicConsistent<HasherT>::GetClosestN(const std::string& key, int count) const {
+    if (count <= 0) {
+        return {};
+    }
+    return GetClosestNByHash(hasher_->Sum64(key), count);
+}
 
-    if (count > static_cast<int>(members_.size())) {
-        throw InsufficientMemberCountException("insufficient number of members");
+template <typename HasherT>
+std::vector<std::shared_ptr<Member>> BasicConsistent<HasherT>::GetClosestN(std::string_view key, int count) const {
+    if (count <= 0) {
+        return {};
     }
+    return GetClosestNByHash(hasher_->Sum64(reinterpret_cast<const uint8_t*>(key.data()), key.size()), count);
+}
 
-    int part_id = GetPartitionID(key);
-    return GetClosestN(part_id, count);
+template <typename HasherT>
+std::vector<std::shared_ptr<Member>> BasicConsistent<HasherT>::GetClosestN(const char* key, int count) const {
+    return GetClosestN(std::string_view(key), count);
 }
 
-std::vector<std::shared_ptr<Member>> Consistent::GetClosestN(const std::string& key, int count) const {
+template <typename HasherT>
+std::vector<std::shared_ptr<Member>> BasicConsistent<HasherT>::GetClosestN(const uint8_t* data, size_t length, int count) const {
     if (count <= 0) {
         return {};
     }
+    return GetClosestNByHash(hasher_->Sum64(data, length), count);
+}
 
-    std::shared_lock<std::shared_mutex> lock(mutex_);
-
-    if (count > static_cast<int>(members_.size())) {
-        throw InsufficientMemberCountException("insufficient number of members");
+template <typename HasherT>
+int BasicConsistent<HasherT>::GetClosestN(std::string_view key, int count, Member** out) const {
+    if (count <= 0) {
+        return 0;
     }
+    uint64_t hkey = hasher_->Sum64(reinterpret_cast<const uint8_t*>(key.data()), key.size());
+    stats_.CountClosestN();
 
-    int part_id = GetPartitionID(key);
-    return GetClosestN(part_id, count);
+    auto guard = epoch_.Read();
+    return GetClosestN(*state_.load(std::memory_order_seq_cst), GetPartitionID(hkey), count, out);
 }
 
-std::vector<std::shared_ptr<Member>> Consistent::GetClosestN(int part_id, int count) const {
-    if (count > static_cast<int>(members_.size())) {
+template <typename HasherT>
+std::vector<std::shared_ptr<Member>> BasicConsistent<HasherT>::GetClosestNByHash(uint64_t hkey, int count) const {
+    stats_.CountClosestN();
+    auto guard = epoch_.Read();
+    const State* state = state_.load(std::memory_order_seq_cst);
+
+    if (count > static_cast<int>(state->members.size())) {
         throw InsufficientMemberCountException("insufficient number of members");
     }
 
-    if (sorted_set_.empty()) {
-        throw InsufficientMemberCountException("insufficient number of members");
+    std::vector<Member*> raw(count);
+    int found = GetClosestN(*state, GetPartitionID(hkey), count, raw.data());
+
+    std::vector<std::shared_ptr<Member>> result;
+    result.reserve(found);
+    for (int i = 0; i < found; ++i) {
+        result.push_back(raw[i]->shared_from_this());
     }
+    return result;
+}
 
-    Member* owner = GetPartitionOwner(part_id);
-    if (!owner) {
+template <typename HasherT>
+int BasicConsistent<HasherT>::GetClosestN(const State& state, int part_id, int count, Member** out) const {
+    if (count > static_cast<int>(state.members.size())) {
         throw InsufficientMemberCountException("insufficient number of members");
     }
 
-    // Hash the owner's name to find a starting position on the ring that corresponds to the owner itself.
-    // This ensures the traversal for replicas starts from the primary member.
-    uint64_t owner_key = config_.hasher->Sum64(owner->String());
-
-    auto it = std::lower_bound(sorted_set_.begin(), sorted_set_.end(), owner_key);
-    int start_idx = std::distance(sorted_set_.begin(), it);
-
-    if (start_idx >= static_cast<int>(sorted_set_.size())) {
-        start_idx = 0;
+    if (state.ring.Empty()) {
+        throw InsufficientMemberCountException("insufficient number of members");
     }
 
-    std::vector<std::shared_ptr<Member>> result;
-    result.reserve(count);
-    std::unordered_set<std::string> seen;
-    int idx = start_idx;
-
-    while (static_cast<int>(result.size()) < count && static_cast<int>(seen.size()) < static_cast<int>(members_.size())) {
-        uint64_t hash = sorted_set_[idx];
-        Member* raw_member = ring_.at(hash);
-        std::string member_key = raw_member->String();
-
-        if (seen.find(member_key) == seen.end()) {
-            result.push_back(raw_member->shared_from_this());
-            seen.insert(member_key);
-        }
+    if (part_id < 0 || part_id >= static_cast<int>(state.partitions.size()) ||
+        state.partitions[part_id] == NO_OWNER) {
+        throw InsufficientMemberCountException("insufficient number of members");
+    }
 
-        idx++;
-        if (idx >= static_cast<int>(sorted_set_.size())) {
-            idx = 0;
+    if (count <= state.replica_count) {
+        const uint32_t* replicas = state.replicas.data() + static_cast<size_t>(part_id) * state.replica_count;
+        for (int i = 0; i < count; ++i) {
+            out[i] = state.member_table[replicas[i]];
         }
+        return count;
     }
 
-    return result;
+    return WalkClosestN(state, part_id, count, out);
 }
 
-Member* Consistent::GetPartitionOwner(int part_id) const {
-    auto it = partitions_.find(part_id);
-    return (it != partitions_.end()) ? it->second : nullptr;
+template <typename HasherT>
+template <typename Out>
+int BasicConsistent<HasherT>::WalkClosestN(const State& state, int part_id, int count, Out* out) const {
+    // Start at the owner's name hash, so the traversal for replicas starts from the primary member.
+    // The hash is computed once when the member takes its slot.
+    size_t idx = FindStartIndex(state, state.name_hashes[state.partitions[part_id]]);
+    return consistent::WalkClosestN(state.ring, state.member_table, idx, count, out);
 }
 
-std::vector<std::shared_ptr<Member>> Consistent::GetMembers() const {
-    // First, try to check the cache with a read lock
-    {
-        std::shared_lock<std::shared_mutex> lock(mutex_);
-        if (!members_dirty_ && !cached_members_.empty()) {
-            // Return shared_ptrs from cached raw pointers
-            std::vector<std::shared_ptr<Member>> result;
-            result.reserve(cached_members_.size());
-            for (Member* raw_member : cached_members_) {
-                result.push_back(raw_member->shared_from_this());
-            }
-            return result;
-        }
-    }
+template <typename HasherT>
+void BasicConsistent<HasherT>::RefreshReplicas(State& state) const {
+    state.replica_count = 0;
+    state.replicas.clear();
 
-    // Acquire write lock to update cache
-    std::unique_lock<std::shared_mutex> lock(mutex_);
+    int count = std::min(config_.precompute_replicas, static_cast<int>(state.members.size()));
+    if (count <= 0 || state.partitions.empty()) {
+        return;
+    }
 
-    // Check again if cache was updated
-    if (!members_dirty_ && !cached_members_.empty()) {
-        // Return shared_ptrs from cached raw pointers
-        std::vector<std::shared_ptr<Member>> result;
-        result.reserve(cached_members_.size());
-        for (Member* raw_member : cached_members_) {
-            result.push_back(raw_member->shared_from_this());
+    state.replicas.resize(partition_count_ * count);
+    for (uint64_t part_id = 0; part_id < partition_count_; ++part_id) {
+        uint32_t* replicas = state.replicas.data() + part_id * count;
+        if (WalkClosestN(state, static_cast<int>(part_id), count, replicas) != count) {
+            // A member lost all of its virtual nodes to hash collisions; leave replica lookups to the walk
+            state.replicas.clear();
+            return;
         }
-        return result;
     }
+    state.replica_count = count;
+}
 
-    // Update cache with raw pointers (no cloning for cache)
-    cached_members_.clear();
-    cached_members_.reserve(members_.size());
-    for (const auto& [name, member] : members_) {
-        cached_members_.push_back(member.get());
+template <typename HasherT>
+Member* BasicConsistent<HasherT>::GetPartitionOwner(const State& state, int part_id) {
+    if (part_id < 0 || part_id >= static_cast<int>(state.partitions.size())) {
+        return nullptr;
     }
-    members_dirty_ = false;
+    uint32_t owner = state.partitions[part_id];
+    return owner != NO_OWNER ? state.member_table[owner] : nullptr;
+}
 
-    // Return shared_ptrs
-    std::vector<std::shared_ptr<Member>> result;
-    result.reserve(members_.size());
-    for (const auto& [name, shared_member] : members_) {
-        result.push_back(shared_member);
-    }
+template <typename HasherT>
+std::shared_ptr<const MemberView> BasicConsistent<HasherT>::GetMemberView() const {
+    auto guard = epoch_.Read();
+    return state_.load(std::memory_order_seq_cst)->view;
+}
 
-    return result;
+template <typename HasherT>
+std::vector<std::shared_ptr<Member>> BasicConsistent<HasherT>::GetMembers() const {
+    return GetMemberView()->members;
 }
 
+template <typename HasherT>
+std::unordered_map<std::string, double> BasicConsistent<HasherT>::LoadDistribution() const {
+    return GetMemberView()->loads;
+}
 
+template <typename HasherT>
+uint64_t BasicConsistent<HasherT>::Epoch() const {
+    auto guard = epoch_.Read();
+    return state_.load(std::memory_order_seq_cst)->epoch;
+}
 
-std::unordered_map<std::string, double> Consistent::LoadDistribution() const {
-    std::shared_lock<std::shared_mutex> lock(mutex_);
-    return loads_;
+template <typename HasherT>
+RingStats BasicConsistent<HasherT>::Stats() const {
+    return stats_.Snapshot();
 }
 
-double Consistent::GetAverageLoad() const {
-    std::shared_lock<std::shared_mutex> lock(mutex_);
-    return AverageLoad();
+template <typename HasherT>
+double BasicConsistent<HasherT>::GetAverageLoad() const {
+    auto guard = epoch_.Read();
+    return AverageLoad(*state_.load(std::memory_order_seq_cst));
 }
 
-double Consistent::AverageLoad() const {
-    if (members_.empty()) {
+template <typename HasherT>
+double BasicConsistent<HasherT>::AverageLoad(const State& state) const {
+    if (state.members.empty()) {
         return 0.0;
     }
-    return static_cast<double>(partition_count_) / members_.size() * config_.load;
+    return static_cast<double>(partition_count_) / state.members.size() * config_.load;
 }
 
-void Consistent::DistributePartitions() {
-    std::unordered_map<std::string, double> loads;
-    std::unordered_map<int, Member*> partitions;
+template <typename HasherT>
+void BasicConsistent<HasherT>::DistributePartitions(State& state) {
+    // No traffic has been recorded yet
+    TrafficBound bound;
+    AssignPartitions(state, LoadCaps(state, false), bound, nullptr);
+}
 
-    for (uint64_t part_id = 0; part_id < partition_count_; ++part_id) {
-        // Convert partition ID to bytes (little endian)
-        std::vector<uint8_t> bs(8);
-        for (int i = 0; i < 8; ++i) {
-            bs[i] = static_cast<uint8_t>((part_id >> (i * 8)) & 0xFF);
-        }
+template <typename HasherT>
+void BasicConsistent<HasherT>::CalculatePartitionsWithRingAndMemberCount(State& state, int member_count,
+                                                                         TrafficBound& bound, MoveLog* log) {
+    if (member_count == 0) {
+        state.loads.assign(state.member_table.size(), 0);
+        state.partitions.assign(partition_count_, NO_OWNER);
+        return;
+    }
+    AssignPartitions(state, LoadCaps(state, true), bound, log);
+}
 
-        uint64_t key = config_.hasher->Sum64(bs);
-        auto it = std::lower_bound(sorted_set_.begin(), sorted_set_.end(), key);
-        int idx = std::distance(sorted_set_.begin(), it);
+template <typename HasherT>
+void BasicConsistent<HasherT>::AssignPartitions(State& state, const ScratchVector<double>& caps,
+                                                TrafficBound& bound, MoveLog* log) {
+    ScratchVector<uint32_t> starts = FindStartIndices(state);
+    ScratchVector<uint32_t> order = PartitionOrder(partition_count_, bound, &scratch_);
+    stats_.CountLoadProbes(
+        consistent::AssignPartitions(state.ring, starts, order, caps, bound, state.partitions, state.loads, log));
+}
 
-        if (idx >= static_cast<int>(sorted_set_.size())) {
-            idx = 0;
-        }
+template <typename HasherT>
+ScratchVector<double> BasicConsistent<HasherT>::LoadCaps(const State& state, bool ceiled) const {
+    return consistent::LoadCaps(state, partition_count_, config_.load, ceiled, &scratch_);
+}
 
-        DistributeWithLoad(static_cast<int>(part_id), idx, partitions, loads);
-    }
+template <typename HasherT>
+ScratchVector<uint32_t> BasicConsistent<HasherT>::FindStartIndices(const State& state) const {
+    return partition_keys_.FindStarts(state.ring, distribution_pool_, &scratch_);
+}
 
-    partitions_ = std::move(partitions);
-    loads_ = std::move(loads);
+template <typename HasherT>
+size_t BasicConsistent<HasherT>::FindStartIndex(const State& state, uint64_t key) {
+    return state.ring.FindStart(key);
 }
 
-void Consistent::DistributeWithLoad(int part_id, int idx,
-                                   std::unordered_map<int, Member*>& partitions,
-                                   std::unordered_map<std::string, double>& loads) {
-    double avg_load = AverageLoad();
-    int count = 0;
+template <typename HasherT>
+uint32_t BasicConsistent<HasherT>::FindOwnerWithCapacity(const State& state, uint64_t part_id, size_t idx,
+                                                         const ScratchVector<double>& caps,
+                                                         const TrafficBound& bound, uint32_t skip) const {
+    uint64_t probes = 0;
+    uint32_t owner = consistent::FindOwnerWithCapacity(state.ring, state.loads, caps, bound, part_id, idx, skip, probes);
+    stats_.CountLoadProbes(probes);
+    return owner;
+}
 
-    while (true) {
-        count++;
-        if (count >= static_cast<int>(sorted_set_.size())) {
-            std::ostringstream oss;
-            oss << "partition " << part_id << " cannot be assigned after " << count
-                << " attempts (avgLoad=" << avg_load << ", members=" << members_.size()
-                << ", virtualNodes=" << sorted_set_.size() << ")";
-            throw InsufficientSpaceException(oss.str());
+template <typename HasherT>
+void BasicConsistent<HasherT>::RebalanceIncrementally(const State& current, State& next,
+                                                      const std::vector<Member*>& added,
+                                                      const std::vector<Member*>& removed, TrafficBound& bound,
+                                                      MoveLog& log) {
+    ScratchVector<double> caps = LoadCaps(next, true);
+
+    // Partitions whose owner was removed. Their slot may already be reused by
+    // an added member (even the removed one again), so this is tracked per
+    // partition rather than per slot.
+    ScratchVector<bool> released(current.member_table.size(), false, &scratch_);
+    for (Member* member : removed) {
+        auto slot = std::find(current.member_table.begin(), current.member_table.end(), member);
+        released[std::distance(current.member_table.begin(), slot)] = true;
+    }
+    ScratchVector<bool> orphaned(partition_count_, false, &scratch_);
+    for (size_t part_id = 0; part_id < partition_count_; ++part_id) {
+        uint32_t slot = next.partitions[part_id];
+        orphaned[part_id] = slot != NO_OWNER && released[slot];
+        if (orphaned[part_id] && bound.Active()) {
+            bound.assigned[slot] -= bound.traffic[part_id];
         }
+    }
 
-        uint64_t hash = sorted_set_[idx];
-        Member* member = ring_[hash];
-        double load = loads[member->String()];
-
-        if (load + 1 <= avg_load) {
-            partitions[part_id] = member;
-            loads[member->String()]++;
-            return;
+    auto move_partition = [&](uint64_t part_id, uint32_t to) {
+        uint32_t from = next.partitions[part_id];
+        if (orphaned[part_id]) {
+            orphaned[part_id] = false;
+        } else if (from != NO_OWNER) {
+            next.loads[from]--;
+            if (bound.Active()) {
+                bound.assigned[from] -= bound.traffic[part_id];
+            }
         }
 
-        idx++;
-        if (idx >= static_cast<int>(sorted_set_.size())) {
-            idx = 0;
+        next.partitions[part_id] = to;
+        next.loads[to]++;
+        if (bound.Active()) {
+            bound.assigned[to] += bound.traffic[part_id];
         }
+        log.Record(part_id, to);
+    };
+
+    // Slots of removed and added members start from zero load in next
+    ScratchVector<bool> added_slots(next.member_table.size(), false, &scratch_);
+    for (Member* member : added) {
+        auto slot = std::find(next.member_table.begin(), next.member_table.end(), member);
+        added_slots[std::distance(next.member_table.begin(), slot)] = true;
     }
-}
 
-std::pair<std::unordered_map<int, Member*>, std::unordered_map<std::string, double>>
-Consistent::CalculatePartitionsWithRingAndMemberCount(
-    const std::unordered_map<uint64_t, Member*>& ring,
-    const std::vector<uint64_t>& sorted_set,
-    int member_count) {
+    // Partitions whose first virtual node now belongs to a new member move to it
+    if (!added.empty()) {
+        ScratchVector<uint32_t> starts = FindStartIndices(next);
+        for (uint64_t part_id = 0; part_id < partition_count_; ++part_id) {
+            uint32_t slot = next.ring.Owner(starts[part_id]);
+            if (added_slots[slot] && (orphaned[part_id] || next.partitions[part_id] != slot) &&
+                next.loads[slot] + 1 <= caps[slot] && bound.Fits(slot, part_id)) {
+                move_partition(part_id, slot);
+            }
+        }
+    }
 
-    std::unordered_map<std::string, double> loads;
-    std::unordered_map<int, Member*> partitions;
+    // Partitions of removed members need a new home
+    if (!removed.empty()) {
+        for (uint32_t part_id : PartitionOrder(partition_count_, bound, &scratch_)) {
+            if (orphaned[part_id]) {
+                size_t idx = FindStartIndex(next, partition_keys_[part_id]);
+                move_partition(part_id, FindOwnerWithCapacity(next, part_id, idx, caps, bound, NO_OWNER));
+            }
+        }
+    }
 
-    if (member_count == 0) {
-        return {partitions, loads};
+    // If the bound shrank, shed partitions from members that are now above it
+    for (uint64_t part_id = partition_count_; part_id-- > 0;) {
+        uint32_t owner = next.partitions[part_id];
+        if (next.loads[owner] > caps[owner]) {
+            size_t idx = FindStartIndex(next, partition_keys_[part_id]);
+            move_partition(part_id, FindOwnerWithCapacity(next, part_id, idx, caps, bound, owner));
+        }
     }
+}
 
-    double avg_load = static_cast<double>(partition_count_) / member_count * config_.load;
-    avg_load = std::ceil(avg_load);
+template <typename HasherT>
+TrafficBound BasicConsistent<HasherT>::RecordedTraffic(const State& state) {
+    TrafficBound bound{ScratchVector<double>(&scratch_), ScratchVector<double>(&scratch_),
+                       ScratchVector<double>(&scratch_)};
+    {
+        std::lock_guard<std::mutex> traffic_lock(traffic_mutex_);
+        bound.traffic.assign(partition_traffic_.begin(), partition_traffic_.end());
+    }
 
-    for (uint64_t part_id = 0; part_id < partition_count_; ++part_id) {
-        // Convert partition ID to bytes (little endian)
-        std::vector<uint8_t> bs(8);
-        for (int i = 0; i < 8; ++i) {
-            bs[i] = static_cast<uint8_t>((part_id >> (i * 8)) & 0xFF);
-        }
+    double total_traffic = std::accumulate(bound.traffic.begin(), bound.traffic.end(), 0.0);
+    if (!(total_traffic > 0) || state.members.empty()) {
+        return bound;
+    }
 
-        uint64_t key = config_.hasher->Sum64(bs);
-        auto it = std::lower_bound(sorted_set.begin(), sorted_set.end(), key);
-        int idx = std::distance(sorted_set.begin(), it);
+    // Same weighted share as the partition count bound
+    bound.caps = LoadCaps(state, false);
+    for (double& cap : bound.caps) {
+        cap = cap / partition_count_ * total_traffic;
+    }
 
-        if (idx >= static_cast<int>(sorted_set.size())) {
-            idx = 0;
+    bound.assigned.assign(state.member_table.size(), 0.0);
+    for (uint64_t part_id = 0; part_id < state.partitions.size(); ++part_id) {
+        uint32_t owner = state.partitions[part_id];
+        if (owner < bound.assigned.size()) {
+            bound.assigned[owner] += bound.traffic[part_id];
         }
+    }
+    return bound;
+}
 
-        int count = 0;
-        while (true) {
-            count++;
-            if (count >= static_cast<int>(sorted_set.size())) {
-                std::ostringstream oss;
-                oss << "failed to assign partition " << part_id << " (avgLoad=" << avg_load
-                    << ", members=" << member_count << ", virtualNodes=" << sorted_set.size() << ")";
-                throw InsufficientSpaceException(oss.str());
-            }
+template <typename HasherT>
+bool BasicConsistent<HasherT>::ShedTraffic(State& next, TrafficBound& bound, MoveLog& log) {
+    if (!bound.Active()) {
+        return false;
+    }
+    ScratchVector<double> caps = LoadCaps(next, true);
 
-            uint64_t hash = sorted_set[idx];
-            Member* member = ring.at(hash);
-            double load = loads[member->String()];
+    // Only members past the hysteresis threshold shed, but they shed all the
+    // way down to their bound
+    ScratchVector<bool> overloaded(bound.caps.size(), false, &scratch_);
+    for (size_t slot = 0; slot < bound.caps.size(); ++slot) {
+        overloaded[slot] = bound.assigned[slot] > bound.caps[slot] * (1 + config_.load_hysteresis);
+    }
 
-            if (load + 1 <= avg_load) {
-                partitions[static_cast<int>(part_id)] = member;
-                loads[member->String()]++;
+    // Heaviest partitions are shed first so the fewest moves bring a member back under its bound
+    bool moved = false;
+    for (uint32_t part_id : PartitionOrder(partition_count_, bound, &scratch_)) {
+        uint32_t from = next.partitions[part_id];
+        double traffic = bound.traffic[part_id];
+        if (!overloaded[from] || bound.assigned[from] <= bound.caps[from] || traffic <= 0) {
+            continue;
+        }
+
+        // Walk clockwise from the partition for a member with room for it under both bounds
+        size_t idx = FindStartIndex(next, partition_keys_[part_id]);
+        for (size_t visited = 0; visited < next.ring.Size(); ++visited) {
+            uint32_t to = next.ring.Owner(idx);
+            if (to != from && next.loads[to] + 1 <= caps[to] && bound.assigned[to] + traffic <= bound.caps[to]) {
+                next.partitions[part_id] = to;
+                next.loads[from]--;
+                next.loads[to]++;
+                bound.assigned[from] -= traffic;
+                bound.assigned[to] += traffic;
+                log.Record(part_id, to);
+                moved = true;
                 break;
             }
 
             idx++;
-            if (idx >= static_cast<int>(sorted_set.size())) {
+            if (idx >= next.ring.Size()) {
                 idx = 0;
             }
         }
     }
+    return moved;
+}
 
-    return {partitions, loads};
+template <typename HasherT>
+std::vector<PartitionMove> BasicConsistent<HasherT>::CollectMoves(const State& before, const State& after,
+                                                                  MoveLog& log) const {
+    // A partition can be recorded by several walks, or be moved back to its owner
+    if (!std::is_sorted(log.parts.begin(), log.parts.end())) {
+        std::sort(log.parts.begin(), log.parts.end());
+    }
+    log.parts.erase(std::unique(log.parts.begin(), log.parts.end()), log.parts.end());
+
+    std::vector<PartitionMove> moves;
+    for (uint32_t part_id : log.parts) {
+        Member* from = GetPartitionOwner(before, static_cast<int>(part_id));
+        Member* to = GetPartitionOwner(after, static_cast<int>(part_id));
+        if (from != to) {
+            moves.push_back({static_cast<int>(part_id), from ? from->shared_from_this() : nullptr,
+                             to ? to->shared_from_this() : nullptr});
+        }
+    }
+    return moves;
 }
 
-void Consistent::InitMember(std::shared_ptr<Member> member) {
-    std::string member_name = member->String();
+template <typename HasherT>
+void BasicConsistent<HasherT>::RecordPartitionLoad(int part_id, double qps) {
+    if (part_id < 0 || part_id >= static_cast<int>(partition_count_)) {
+        throw std::out_of_range("partition id out of range");
+    }
+    std::lock_guard<std::mutex> lock(traffic_mutex_);
+    partition_traffic_[part_id] = qps;
+}
 
-    members_[member_name] = member;
-    Member* stable_ptr = member.get();
+template <typename HasherT>
+void BasicConsistent<HasherT>::RecordPartitionLoads(const std::vector<double>& qps) {
+    if (qps.size() != partition_count_) {
+        throw std::invalid_argument("expected one load per partition");
+    }
+    std::lock_guard<std::mutex> lock(traffic_mutex_);
+    partition_traffic_ = qps;
+}
 
-    for (int i = 0; i < config_.replication_factor; ++i) {
-        auto key = BuildVirtualNodeKey(member_name, i);
-        uint64_t h = config_.hasher->Sum64(key);
-        ring_[h] = stable_ptr;  // Use stable pointer from members_
-        sorted_set_.push_back(h);
+template <typename HasherT>
+std::vector<PartitionMove> BasicConsistent<HasherT>::RebalanceByLoad() {
+    uint64_t wait_start = StatsCollector::Now();
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    auto rebalance = stats_.Rebalance(wait_start);
+    scratch_.Reset();
+    const State* current = state_.load(std::memory_order_acquire);
+
+    if (current->members.empty()) {
+        return {};
     }
 
-    // Sort the hash values in ascending order
-    std::sort(sorted_set_.begin(), sorted_set_.end());
-    members_dirty_ = true;
-}
+    auto next = NextState(*current);
+    TrafficBound bound = RecordedTraffic(*next);
+    MoveLog log{&current->partitions, nullptr, ScratchVector<uint32_t>(&scratch_)};
+    if (!ShedTraffic(*next, bound, log)) {
+        return {};
+    }
+    std::vector<PartitionMove> moves = CollectMoves(*current, *next, log);
 
-std::vector<uint8_t> Consistent::BuildVirtualNodeKey(const std::string& member_str, int index) const {
-    std::string index_str = std::to_string(index);
-    std::vector<uint8_t> key;
-    key.reserve(member_str.size() + index_str.size());
+    RefreshReplicas(*next);
+    next->epoch = current->epoch + 1;
 
-    // Append member string
-    for (char c : member_str) {
-        key.push_back(static_cast<uint8_t>(c));
+    std::vector<uint8_t> delta;
+    if (config_.on_ring_delta) {
+        delta = EncodeDelta(*current, *next, {}, {}, log);
     }
+    uint64_t epoch = next->epoch;
+    Publish(next.Release());
+    NotifyMoves(moves);
+    NotifyDelta(epoch, delta);
+    rebalance.Finish(epoch, moves.size(), config_.stats_sink);
+    return moves;
+}
 
-    // Append index string
-    for (char c : index_str) {
-        key.push_back(static_cast<uint8_t>(c));
+template <typename HasherT>
+void BasicConsistent<HasherT>::NotifyMoves(const std::vector<PartitionMove>& moves) const {
+    if (config_.on_partition_moves && !moves.empty()) {
+        config_.on_partition_moves(moves);
     }
+}
+
+template <typename HasherT>
+void BasicConsistent<HasherT>::InitMember(State& state, std::shared_ptr<Member> member) {
+    const std::string& member_name = member->Name();
 
-    return key;
+    // A repeated name replaces the earlier member in place
+    auto existing = state.members.find(member_name);
+    if (existing != state.members.end()) {
+        ReleaseSlot(state, existing->second.get());
+    }
+
+    // The freed slot is taken again right away, so the earlier member's
+    // entries collapse into the new ones when the ring is built
+    state.members[member_name] = member;
+    AddToRing(state, member, member_name);
 }
 
+template class BasicConsistent<Hasher>;
+template class BasicConsistent<CRC64Hasher>;
+template class BasicConsistent<FNVHasher>;
+template class BasicConsistent<XXH3Hasher>;
+template class BasicConsistent<WyHasher>;
+
 } // namespace consistent
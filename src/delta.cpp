@@ -0,0 +1,375 @@
+#include "consistent.h"
+#include <cstring>
+#include <unordered_map>
+
+namespace consistent {
+
+namespace {
+
+// Delta layout. Integers are LEB128 varints unless noted; fixed-width fields
+// are little-endian, so deltas move between hosts of any byte order:
+//
+//   magic          uint32
+//   version
+//   fingerprint    uint64, hasher fingerprint
+//   partition_count, replication_factor
+//   base_epoch, epoch
+//   slot_count     member table size after the change
+//   removed        count, then (length, name bytes) per member
+//   added          count, then (slot, weight as uint64 bits, length, name bytes)
+//   moves          count, then (part_id gap from the previous move, owner slot + 1)
+//   checksum       uint64, CRC-64 of everything before it
+//
+// Moves list every partition whose owner changed, in ascending order; an
+// owner of 0 means the partition has none.
+constexpr uint32_t DELTA_MAGIC = 0x44524843; // "CHRD"
+
+class DeltaWriter {
+public:
+    void Varint(uint64_t value) {
+        while (value >= 0x80) {
+            out_.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out_.push_back(static_cast<uint8_t>(value));
+    }
+
+    void Fixed(uint64_t value, int bytes) {
+        for (int i = 0; i < bytes; ++i) {
+            out_.push_back(static_cast<uint8_t>(value >> (8 * i)));
+        }
+    }
+
+    void String(const std::string& value) {
+        Varint(value.size());
+        out_.insert(out_.end(), value.begin(), value.end());
+    }
+
+    std::vector<uint8_t> Finish() {
+        Fixed(CRC64Hasher().Sum64(out_.data(), out_.size()), 8);
+        return std::move(out_);
+    }
+
+private:
+    std::vector<uint8_t> out_;
+};
+
+class DeltaReader {
+public:
+    DeltaReader(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+    uint64_t Varint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            uint8_t byte = Byte();
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) {
+                return value;
+            }
+        }
+        throw InvalidDeltaException("delta has a malformed integer");
+    }
+
+    uint64_t Fixed(int bytes) {
+        uint64_t value = 0;
+        for (int i = 0; i < bytes; ++i) {
+            value |= static_cast<uint64_t>(Byte()) << (8 * i);
+        }
+        return value;
+    }
+
+    std::string String() {
+        uint64_t length = Varint();
+        if (length > size_ - pos_) {
+            throw InvalidDeltaException("delta is truncated");
+        }
+        std::string value(reinterpret_cast<const char*>(data_ + pos_), length);
+        pos_ += length;
+        return value;
+    }
+
+    // Counts are bounded by the remaining bytes, so a damaged count cannot
+    // trigger a huge allocation
+    uint64_t Count() {
+        uint64_t count = Varint();
+        if (count > size_ - pos_) {
+            throw InvalidDeltaException("delta is truncated");
+        }
+        return count;
+    }
+
+    bool Done() const { return pos_ == size_; }
+
+private:
+    uint8_t Byte() {
+        if (pos_ >= size_) {
+            throw InvalidDeltaException("delta is truncated");
+        }
+        return data_[pos_++];
+    }
+
+    const uint8_t* data_;
+    size_t size_;
+    size_t pos_ = 0;
+};
+
+uint64_t DoubleBits(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+struct AddedMember {
+    uint32_t slot;
+    double weight;
+    std::string name;
+};
+
+} // namespace
+
+template <typename HasherT>
+std::vector<uint8_t> BasicConsistent<HasherT>::EncodeDelta(const State& current, const State& next,
+                                                           const std::vector<std::string>& removed,
+                                                           const std::vector<uint32_t>& added,
+                                                           const MoveLog& log) const {
+    DeltaWriter writer;
+    writer.Fixed(DELTA_MAGIC, 4);
+    writer.Varint(DELTA_VERSION);
+    writer.Fixed(HasherFingerprint(), 8);
+    writer.Varint(partition_count_);
+    writer.Varint(static_cast<uint64_t>(config_.replication_factor));
+    writer.Varint(current.epoch);
+    writer.Varint(next.epoch);
+    writer.Varint(next.member_table.size());
+
+    writer.Varint(removed.size());
+    for (const auto& name : removed) {
+        writer.String(name);
+    }
+
+    writer.Varint(added.size());
+    for (uint32_t slot : added) {
+        writer.Varint(slot);
+        writer.Fixed(DoubleBits(next.weights[slot]), 8);
+        writer.String(next.names[slot]);
+    }
+
+    // Either side may be an empty ring without a partition table
+    auto owner = [](const State& state, uint64_t part_id) {
+        return part_id < state.partitions.size() ? state.partitions[part_id] : NO_OWNER;
+    };
+    // A reused slot keeps its number but changes member
+    auto changed = [&](uint64_t part_id) {
+        uint32_t slot = owner(next, part_id);
+        return owner(current, part_id) != slot ||
+               (slot != NO_OWNER && current.member_table[slot] != next.member_table[slot]);
+    };
+    ScratchVector<uint32_t> moved(&scratch_);
+    for (uint32_t part_id : log.parts) {
+        if (changed(part_id)) {
+            moved.push_back(part_id);
+        }
+    }
+
+    writer.Varint(moved.size());
+    uint64_t previous = 0;
+    for (uint64_t part_id : moved) {
+        writer.Varint(part_id - previous);
+        writer.Varint(static_cast<uint64_t>(owner(next, part_id)) + 1);
+        previous = part_id;
+    }
+    return writer.Finish();
+}
+
+template <typename HasherT>
+void BasicConsistent<HasherT>::NotifyDelta(uint64_t epoch, const std::vector<uint8_t>& delta) const {
+    if (config_.on_ring_delta) {
+        config_.on_ring_delta(epoch, delta);
+    }
+}
+
+template <typename HasherT>
+std::vector<PartitionMove> BasicConsistent<HasherT>::ApplyDelta(
+    const uint8_t* data, size_t size, const std::vector<std::shared_ptr<Member>>& members) {
+
+    if (size < 12) {
+        throw InvalidDeltaException("delta is truncated");
+    }
+    DeltaReader checksum(data + size - 8, 8);
+    if (CRC64Hasher().Sum64(data, size - 8) != checksum.Fixed(8)) {
+        throw InvalidDeltaException("delta checksum mismatch");
+    }
+
+    // Decode everything up front so a bad delta never leaves a half-applied ring
+    DeltaReader reader(data, size - 8);
+    if (reader.Fixed(4) != DELTA_MAGIC) {
+        throw InvalidDeltaException("not a ring delta");
+    }
+    uint64_t version = reader.Varint();
+    if (version != DELTA_VERSION) {
+        throw InvalidDeltaException("unsupported delta version " + std::to_string(version));
+    }
+    if (reader.Fixed(8) != HasherFingerprint()) {
+        throw InvalidDeltaException("delta was encoded with a different hasher");
+    }
+    if (reader.Varint() != partition_count_ ||
+        reader.Varint() != static_cast<uint64_t>(config_.replication_factor)) {
+        throw InvalidDeltaException("delta was encoded with a different placement config");
+    }
+    uint64_t base_epoch = reader.Varint();
+    uint64_t epoch = reader.Varint();
+    uint64_t slot_count = reader.Varint();
+    if (epoch != base_epoch + 1) {
+        throw InvalidDeltaException("delta does not advance the epoch by one");
+    }
+
+    std::vector<std::string> removes(reader.Count());
+    for (auto& name : removes) {
+        name = reader.String();
+    }
+
+    std::vector<AddedMember> adds(reader.Count());
+    for (auto& add : adds) {
+        add.slot = static_cast<uint32_t>(reader.Varint());
+        uint64_t bits = reader.Fixed(8);
+        std::memcpy(&add.weight, &bits, sizeof(bits));
+        add.name = reader.String();
+    }
+
+    std::vector<std::pair<uint64_t, uint64_t>> owners(reader.Count());
+    uint64_t part_id = 0;
+    for (size_t i = 0; i < owners.size(); ++i) {
+        uint64_t gap = reader.Varint();
+        if (gap == 0 && i > 0) {
+            throw InvalidDeltaException("delta moves a partition twice");
+        }
+        part_id += gap;
+        if (part_id >= partition_count_) {
+            throw InvalidDeltaException("delta moves a partition out of range");
+        }
+        owners[i] = {part_id, reader.Varint()};
+    }
+    if (!reader.Done()) {
+        throw InvalidDeltaException("delta has trailing bytes");
+    }
+
+    std::unordered_map<std::string_view, std::shared_ptr<Member>> by_name;
+    for (const auto& member : members) {
+        by_name.emplace(member->Name(), member);
+    }
+
+    uint64_t wait_start = StatsCollector::Now();
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    auto rebalance = stats_.Rebalance(wait_start);
+    scratch_.Reset();
+    const State* current = state_.load(std::memory_order_acquire);
+    if (base_epoch != current->epoch) {
+        throw StaleRingException("delta applies to epoch " + std::to_string(base_epoch) +
+                                 ", ring is at epoch " + std::to_string(current->epoch));
+    }
+
+    // Replay the membership change the way ApplyChanges made it, so every
+    // member lands in the same slot as on the coordinator
+    auto next = NextState(*current);
+    next->epoch = epoch;
+
+    std::vector<bool> removed_slots(next->member_table.size(), false);
+    for (const auto& name : removes) {
+        auto existing = next->members.find(name);
+        if (existing == next->members.end()) {
+            throw InvalidDeltaException("delta removes unknown member " + name);
+        }
+        removed_slots[ReleaseSlot(*next, existing->second.get())] = true;
+        next->members.erase(existing);
+    }
+    if (!removes.empty()) {
+        next->ring.RemoveOwners(removed_slots);
+    }
+
+    for (const auto& add : adds) {
+        auto member = by_name.find(add.name);
+        if (member == by_name.end()) {
+            throw InvalidDeltaException("delta member " + add.name + " was not provided");
+        }
+        if (next->members.find(add.name) != next->members.end()) {
+            throw InvalidDeltaException("delta adds existing member " + add.name);
+        }
+        if (member->second->Weight() != add.weight) {
+            throw InvalidDeltaException("delta member " + add.name + " has a different weight");
+        }
+
+        next->members[add.name] = member->second;
+        if (AddToRing(*next, member->second, add.name) != add.slot) {
+            throw InvalidDeltaException("delta member " + add.name + " lands in a different slot");
+        }
+    }
+    if (!removes.empty() || !adds.empty()) {
+        next->ring.Build(&scratch_);
+    }
+    if (next->member_table.size() != slot_count) {
+        throw InvalidDeltaException("delta member table does not match the ring");
+    }
+
+    if (next->members.empty()) {
+        next->partitions.clear();
+    } else {
+        if (next->partitions.empty()) {
+            next->partitions.assign(partition_count_, NO_OWNER);
+        }
+        for (const auto& [moved, owner] : owners) {
+            if (owner == 0 || owner > slot_count || !next->member_table[owner - 1]) {
+                throw InvalidDeltaException("delta moves a partition to a free slot");
+            }
+            next->partitions[moved] = static_cast<uint32_t>(owner - 1);
+        }
+
+        // Loads follow from the owners, and every partition must have one
+        std::fill(next->loads.begin(), next->loads.end(), 0);
+        for (uint32_t owner : next->partitions) {
+            if (owner == NO_OWNER || !next->member_table[owner]) {
+                throw InvalidDeltaException("delta leaves a partition without an owner");
+            }
+            next->loads[owner]++;
+        }
+    }
+
+    // Only the partitions listed can have changed owner
+    std::vector<PartitionMove> moves;
+    for (const auto& [moved, owner] : owners) {
+        Member* from = GetPartitionOwner(*current, static_cast<int>(moved));
+        Member* to = GetPartitionOwner(*next, static_cast<int>(moved));
+        if (from != to) {
+            moves.push_back({static_cast<int>(moved), from ? from->shared_from_this() : nullptr,
+                             to ? to->shared_from_this() : nullptr});
+        }
+    }
+
+    RefreshReplicas(*next);
+    Publish(next.Release());
+    NotifyMoves(moves);
+
+    // Relays pass the delta on unchanged
+    if (config_.on_ring_delta) {
+        NotifyDelta(epoch, std::vector<uint8_t>(data, data + size));
+    }
+    rebalance.Finish(epoch, moves.size(), config_.stats_sink);
+    return moves;
+}
+
+#define CONSISTENT_INSTANTIATE_DELTA(H)                                                                      \
+    template std::vector<uint8_t> BasicConsistent<H>::EncodeDelta(                                           \
+        const State&, const State&, const std::vector<std::string>&, const std::vector<uint32_t>&,          \
+        const MoveLog&) const;                                                                              \
+    template void BasicConsistent<H>::NotifyDelta(uint64_t, const std::vector<uint8_t>&) const;              \
+    template std::vector<PartitionMove> BasicConsistent<H>::ApplyDelta(                                      \
+        const uint8_t*, size_t, const std::vector<std::shared_ptr<Member>>&);
+
+CONSISTENT_INSTANTIATE_DELTA(Hasher)
+CONSISTENT_INSTANTIATE_DELTA(CRC64Hasher)
+CONSISTENT_INSTANTIATE_DELTA(FNVHasher)
+CONSISTENT_INSTANTIATE_DELTA(XXH3Hasher)
+CONSISTENT_INSTANTIATE_DELTA(WyHasher)
+
+#undef CONSISTENT_INSTANTIATE_DELTA
+
+} // namespace consistent
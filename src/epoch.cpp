@@ -0,0 +1,45 @@
+#include "epoch.h"
+#include <thread>
+
+namespace consistent {
+
+EpochDomain::ReadGuard::ReadGuard(const EpochDomain& domain)
+    : domain_(domain), slot_(ThreadSlot()) {
+    // The epoch may flip between the load and the increment; Synchronize()
+    // drains both parities so a stale read here is still waited for.
+    epoch_ = domain_.epoch_.load(std::memory_order_seq_cst) & 1;
+    domain_.slots_[slot_].active[epoch_].fetch_add(1, std::memory_order_seq_cst);
+}
+
+EpochDomain::ReadGuard::~ReadGuard() {
+    domain_.slots_[slot_].active[epoch_].fetch_sub(1, std::memory_order_release);
+}
+
+size_t EpochDomain::ThreadSlot() {
+    // Spread threads round-robin so concurrent readers rarely share a slot.
+    static std::atomic<size_t> next_slot{0};
+    thread_local const size_t slot = next_slot.fetch_add(1, std::memory_order_relaxed) % SLOT_COUNT;
+    return slot;
+}
+
+void EpochDomain::WaitForReaders(unsigned epoch) const {
+    for (const auto& slot : slots_) {
+        while (slot.active[epoch].load(std::memory_order_seq_cst) != 0) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void EpochDomain::Synchronize() {
+    std::lock_guard<std::mutex> lock(sync_mutex_);
+
+    // Flip twice so readers that sampled the epoch just before a flip are
+    // caught by the second drain.
+    for (int round = 0; round < 2; ++round) {
+        unsigned old_epoch = epoch_.load(std::memory_order_seq_cst) & 1;
+        epoch_.store(old_epoch ^ 1, std::memory_order_seq_cst);
+        WaitForReaders(old_epoch);
+    }
+}
+
+} // namespace consistent
@@ -1,10 +1,276 @@
 #include "hasher.h"
+#include <cstring>
 #include <mutex>
 
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#include <immintrin.h>
+#elif defined(__aarch64__) && (defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_AES))
+#include <arm_neon.h>
+#if defined(__linux__)
+#include <asm/hwcap.h>
+#include <sys/auxv.h>
+#endif
+#endif
+
 namespace consistent {
 
-// CRC64Hasher static members
-std::vector<uint64_t> CRC64Hasher::crc64_table_(256);
+uint64_t Hasher::Sum64(const uint8_t* data, size_t length) const {
+    return Sum64(std::vector<uint8_t>(data, data + length));
+}
+
+void Hasher::Sum64Batch(const std::string* keys, size_t count, uint64_t* out) const {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = Sum64(keys[i]);
+    }
+}
+
+void Hasher::Sum64Batch(const std::string_view* keys, size_t count, uint64_t* out) const {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = Sum64(reinterpret_cast<const uint8_t*>(keys[i].data()), keys[i].size());
+    }
+}
+
+// CRC64Hasher .
+namespace {
+
+// crc64_tables[0] is the classic byte-at-a-time table; crc64_tables[k] advances
+// a byte through k further zero bytes, which is what slicing-by-8 needs.
+uint64_t crc64_tables[8][256];
+
+using CRC64Update = uint64_t (*)(uint64_t crc, const uint8_t* data, size_t length);
+
+// Inputs shorter than this are not worth the folding setup
+constexpr size_t CLMUL_MIN_LENGTH = 32;
+
+uint64_t UpdateCRC64Bytewise(uint64_t crc, const uint8_t* data, size_t length) {
+    for (size_t i = 0; i < length; ++i) {
+        crc = crc64_tables[0][(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+uint64_t UpdateCRC64Slicing8(uint64_t crc, const uint8_t* data, size_t length) {
+    while (length >= 8) {
+        uint64_t word = 0;
+        for (int i = 0; i < 8; ++i) {
+            word |= static_cast<uint64_t>(data[i]) << (i * 8);
+        }
+        crc ^= word;
+        crc = crc64_tables[7][crc & 0xFF] ^
+              crc64_tables[6][(crc >> 8) & 0xFF] ^
+              crc64_tables[5][(crc >> 16) & 0xFF] ^
+              crc64_tables[4][(crc >> 24) & 0xFF] ^
+              crc64_tables[3][(crc >> 32) & 0xFF] ^
+              crc64_tables[2][(crc >> 40) & 0xFF] ^
+              crc64_tables[1][(crc >> 48) & 0xFF] ^
+              crc64_tables[0][crc >> 56];
+        data += 8;
+        length -= 8;
+    }
+    return UpdateCRC64Bytewise(crc, data, length);
+}
+
+// Folding constants. A 16-byte block that sits n bytes ahead of the rest of the
+// message is reduced by multiplying its first (higher degree) 8 bytes by
+// x^(8n+63) mod P and its last 8 bytes by x^(8n-1) mod P; the extra -1 absorbs
+// the one-bit offset a carry-less multiply of bit-reflected operands produces.
+uint64_t ReflectedXPowModP(unsigned exponent) {
+    const uint64_t poly = 0x1BULL;  // x^64 + x^4 + x^3 + x + 1, without the x^64 term
+    uint64_t r = 1;
+    for (unsigned i = 0; i < exponent; ++i) {
+        r = (r & (1ULL << 63)) ? ((r << 1) ^ poly) : (r << 1);
+    }
+    uint64_t reflected = 0;
+    for (int i = 0; i < 64; ++i) {
+        if (r & (1ULL << i)) {
+            reflected |= 1ULL << (63 - i);
+        }
+    }
+    return reflected;
+}
+
+struct FoldConstants {
+    uint64_t lo;
+    uint64_t hi;
+};
+
+FoldConstants fold16, fold32, fold48, fold64;
+
+FoldConstants MakeFoldConstants(unsigned distance) {
+    return {ReflectedXPowModP(distance * 8 + 63), ReflectedXPowModP(distance * 8 - 1)};
+}
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define CONSISTENT_CRC64_CLMUL_X86 1
+
+__attribute__((target("pclmul,sse4.1")))
+inline __m128i Fold(__m128i acc, __m128i constants) {
+    __m128i lo = _mm_clmulepi64_si128(acc, constants, 0x00);
+    __m128i hi = _mm_clmulepi64_si128(acc, constants, 0x11);
+    return _mm_xor_si128(lo, hi);
+}
+
+__attribute__((target("pclmul,sse4.1")))
+inline __m128i Load128(const uint8_t* data) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+}
+
+__attribute__((target("pclmul,sse4.1")))
+uint64_t UpdateCRC64Clmul(uint64_t crc, const uint8_t* data, size_t length) {
+    if (length < CLMUL_MIN_LENGTH) {
+        return UpdateCRC64Slicing8(crc, data, length);
+    }
+
+    const __m128i k16 = _mm_set_epi64x(static_cast<long long>(fold16.hi), static_cast<long long>(fold16.lo));
+
+    // Feeding the register into the first 8 message bytes lets folding start from zero
+    __m128i acc = _mm_xor_si128(Load128(data), _mm_cvtsi64_si128(static_cast<long long>(crc)));
+    data += 16;
+    length -= 16;
+
+    if (length >= 112) {
+        const __m128i k64 = _mm_set_epi64x(static_cast<long long>(fold64.hi), static_cast<long long>(fold64.lo));
+        const __m128i k48 = _mm_set_epi64x(static_cast<long long>(fold48.hi), static_cast<long long>(fold48.lo));
+        const __m128i k32 = _mm_set_epi64x(static_cast<long long>(fold32.hi), static_cast<long long>(fold32.lo));
+
+        // Four independent lanes hide the multiply latency on long inputs
+        __m128i acc1 = Load128(data);
+        __m128i acc2 = Load128(data + 16);
+        __m128i acc3 = Load128(data + 32);
+        data += 48;
+        length -= 48;
+
+        while (length >= 64) {
+            acc = _mm_xor_si128(Fold(acc, k64), Load128(data));
+            acc1 = _mm_xor_si128(Fold(acc1, k64), Load128(data + 16));
+            acc2 = _mm_xor_si128(Fold(acc2, k64), Load128(data + 32));
+            acc3 = _mm_xor_si128(Fold(acc3, k64), Load128(data + 48));
+            data += 64;
+            length -= 64;
+        }
+
+        acc = _mm_xor_si128(_mm_xor_si128(Fold(acc, k48), Fold(acc1, k32)),
+                            _mm_xor_si128(Fold(acc2, k16), acc3));
+    }
+
+    while (length >= 16) {
+        acc = _mm_xor_si128(Fold(acc, k16), Load128(data));
+        data += 16;
+        length -= 16;
+    }
+
+    // The remaining 128 bits are congruent to the folded message; finish with tables
+    uint8_t folded[16];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(folded), acc);
+    return UpdateCRC64Slicing8(UpdateCRC64Slicing8(0, folded, sizeof(folded)), data, length);
+}
+
+bool CPUSupportsClmul() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1");
+}
+
+#elif defined(__aarch64__) && (defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_AES))
+#define CONSISTENT_CRC64_CLMUL_ARM 1
+
+inline uint64x2_t Fold(uint64x2_t acc, uint64x2_t constants) {
+    poly128_t lo = vmull_p64(static_cast<poly64_t>(vgetq_lane_u64(acc, 0)),
+                             static_cast<poly64_t>(vgetq_lane_u64(constants, 0)));
+    poly128_t hi = vmull_high_p64(vreinterpretq_p64_u64(acc), vreinterpretq_p64_u64(constants));
+    return veorq_u64(vreinterpretq_u64_p128(lo), vreinterpretq_u64_p128(hi));
+}
+
+inline uint64x2_t MakeConstants(const FoldConstants& k) {
+    return vcombine_u64(vcreate_u64(k.lo), vcreate_u64(k.hi));
+}
+
+uint64_t UpdateCRC64Clmul(uint64_t crc, const uint8_t* data, size_t length) {
+    if (length < CLMUL_MIN_LENGTH) {
+        return UpdateCRC64Slicing8(crc, data, length);
+    }
+
+    const uint64x2_t k16 = MakeConstants(fold16);
+
+    // Feeding the register into the first 8 message bytes lets folding start from zero
+    uint64x2_t acc = veorq_u64(vld1q_u64(reinterpret_cast<const uint64_t*>(data)),
+                               vcombine_u64(vcreate_u64(crc), vcreate_u64(0)));
+    data += 16;
+    length -= 16;
+
+    if (length >= 112) {
+        const uint64x2_t k64 = MakeConstants(fold64);
+        const uint64x2_t k48 = MakeConstants(fold48);
+        const uint64x2_t k32 = MakeConstants(fold32);
+
+        // Four independent lanes hide the multiply latency on long inputs
+        uint64x2_t acc1 = vld1q_u64(reinterpret_cast<const uint64_t*>(data));
+        uint64x2_t acc2 = vld1q_u64(reinterpret_cast<const uint64_t*>(data + 16));
+        uint64x2_t acc3 = vld1q_u64(reinterpret_cast<const uint64_t*>(data + 32));
+        data += 48;
+        length -= 48;
+
+        while (length >= 64) {
+            acc = veorq_u64(Fold(acc, k64), vld1q_u64(reinterpret_cast<const uint64_t*>(data)));
+            acc1 = veorq_u64(Fold(acc1, k64), vld1q_u64(reinterpret_cast<const uint64_t*>(data + 16)));
+            acc2 = veorq_u64(Fold(acc2, k64), vld1q_u64(reinterpret_cast<const uint64_t*>(data + 32)));
+            acc3 = veorq_u64(Fold(acc3, k64), vld1q_u64(reinterpret_cast<const uint64_t*>(data + 48)));
+            data += 64;
+            length -= 64;
+        }
+
+        acc = veorq_u64(veorq_u64(Fold(acc, k48), Fold(acc1, k32)),
+                        veorq_u64(Fold(acc2, k16), acc3));
+    }
+
+    while (length >= 16) {
+        acc = veorq_u64(Fold(acc, k16), vld1q_u64(reinterpret_cast<const uint64_t*>(data)));
+        data += 16;
+        length -= 16;
+    }
+
+    // The remaining 128 bits are congruent to the folded message; finish with tables
+    uint8_t folded[16];
+    vst1q_u64(reinterpret_cast<uint64_t*>(folded), acc);
+    return UpdateCRC64Slicing8(UpdateCRC64Slicing8(0, folded, sizeof(folded)), data, length);
+}
+
+bool CPUSupportsClmul() {
+#if defined(__linux__)
+    return (getauxval(AT_HWCAP) & HWCAP_PMULL) != 0;
+#else
+    return true;
+#endif
+}
+
+#endif
+
+CRC64Update crc64_update = UpdateCRC64Slicing8;
+
+// Guards against a miscompiled or mis-detected fast path: it is only enabled
+// if it matches the table implementation on every length and alignment tried.
+bool SelfTest(CRC64Update candidate) {
+    uint8_t buffer[512 + 16];
+    uint64_t seed = 0x9E3779B97F4A7C15ULL;
+    for (auto& byte : buffer) {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        byte = static_cast<uint8_t>(seed);
+    }
+
+    for (size_t offset = 0; offset < 16; offset += 5) {
+        for (size_t length = 0; length <= 512; ++length) {
+            uint64_t crc = 0xFFFFFFFFFFFFFFFFULL ^ length;
+            if (candidate(crc, buffer + offset, length) != UpdateCRC64Bytewise(crc, buffer + offset, length)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace
+
 std::once_flag CRC64Hasher::table_init_flag_;
 
 void CRC64Hasher::InitializeTable() {
@@ -18,26 +284,55 @@ void CRC64Hasher::InitializeTable() {
                     crc >>= 1;
                 }
             }
-            crc64_table_[i] = crc;
+            crc64_tables[0][i] = crc;
+        }
+
+        for (int k = 1; k < 8; ++k) {
+            for (uint32_t i = 0; i < 256; ++i) {
+                uint64_t prev = crc64_tables[k - 1][i];
+                crc64_tables[k][i] = crc64_tables[0][prev & 0xFF] ^ (prev >> 8);
+            }
         }
+
+        fold16 = MakeFoldConstants(16);
+        fold32 = MakeFoldConstants(32);
+        fold48 = MakeFoldConstants(48);
+        fold64 = MakeFoldConstants(64);
+
+#if defined(CONSISTENT_CRC64_CLMUL_X86) || defined(CONSISTENT_CRC64_CLMUL_ARM)
+        if (CPUSupportsClmul() && SelfTest(UpdateCRC64Clmul)) {
+            crc64_update = UpdateCRC64Clmul;
+        }
+#endif
     });
 }
 
 uint64_t CRC64Hasher::CalculateCRC64(const uint8_t* data, size_t length) {
-    uint64_t crc = 0xFFFFFFFFFFFFFFFFULL;
-    
-    for (size_t i = 0; i < length; ++i) {
-        uint8_t byte = data[i];
-        crc = crc64_table_[(crc ^ byte) & 0xFF] ^ (crc >> 8);
+    return crc64_update(0xFFFFFFFFFFFFFFFFULL, data, length) ^ 0xFFFFFFFFFFFFFFFFULL;
+}
+
+template <typename Key>
+void CRC64Hasher::CalculateCRC64Batch(const Key* keys, size_t count, uint64_t* out) {
+    // Each key already runs several independent lookups or multiplies per step
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = CalculateCRC64(reinterpret_cast<const uint8_t*>(keys[i].data()), keys[i].size());
     }
-    
-    return crc ^ 0xFFFFFFFFFFFFFFFFULL;
 }
 
 CRC64Hasher::CRC64Hasher() {
     InitializeTable();
 }
 
+bool CRC64Hasher::Accelerated() {
+    InitializeTable();
+    return crc64_update != UpdateCRC64Slicing8;
+}
+
+uint64_t CRC64Hasher::Sum64Table(const uint8_t* data, size_t length) {
+    InitializeTable();
+    return UpdateCRC64Slicing8(0xFFFFFFFFFFFFFFFFULL, data, length) ^ 0xFFFFFFFFFFFFFFFFULL;
+}
+
 uint64_t CRC64Hasher::Sum64(const std::vector<uint8_t>& data) const {
     return CalculateCRC64(data.data(), data.size());
 }
@@ -46,27 +341,493 @@ uint64_t CRC64Hasher::Sum64(const std::string& data) const {
     return CalculateCRC64(reinterpret_cast<const uint8_t*>(data.data()), data.size());
 }
 
+uint64_t CRC64Hasher::Sum64(const uint8_t* data, size_t length) const {
+    return CalculateCRC64(data, length);
+}
+
+void CRC64Hasher::Sum64Batch(const std::string* keys, size_t count, uint64_t* out) const {
+    CalculateCRC64Batch(keys, count, out);
+}
+
+void CRC64Hasher::Sum64Batch(const std::string_view* keys, size_t count, uint64_t* out) const {
+    CalculateCRC64Batch(keys, count, out);
+}
+
 // FNVHasher .
-uint64_t FNVHasher::Sum64(const std::vector<uint8_t>& data) const {
+uint64_t FNVHasher::CalculateFNV(const uint8_t* data, size_t length) {
     uint64_t hash = FNV_OFFSET_BASIS;
-    
-    for (uint8_t byte : data) {
-        hash ^= byte;
+
+    for (size_t i = 0; i < length; ++i) {
+        hash ^= data[i];
         hash *= FNV_PRIME;
     }
-    
+
     return hash;
 }
 
+template <typename Key>
+void FNVHasher::CalculateFNVBatch(const Key* keys, size_t count, uint64_t* out) {
+    size_t i = 0;
+
+    // Run two keys side by side so their multiply chains overlap
+    for (; i + 1 < count; i += 2) {
+        const auto* a = reinterpret_cast<const uint8_t*>(keys[i].data());
+        const auto* b = reinterpret_cast<const uint8_t*>(keys[i + 1].data());
+        size_t a_len = keys[i].size();
+        size_t b_len = keys[i + 1].size();
+        size_t common = a_len < b_len ? a_len : b_len;
+
+        uint64_t hash_a = FNV_OFFSET_BASIS;
+        uint64_t hash_b = FNV_OFFSET_BASIS;
+        for (size_t j = 0; j < common; ++j) {
+            hash_a = (hash_a ^ a[j]) * FNV_PRIME;
+            hash_b = (hash_b ^ b[j]) * FNV_PRIME;
+        }
+        for (size_t j = common; j < a_len; ++j) {
+            hash_a = (hash_a ^ a[j]) * FNV_PRIME;
+        }
+        for (size_t j = common; j < b_len; ++j) {
+            hash_b = (hash_b ^ b[j]) * FNV_PRIME;
+        }
+
+        out[i] = hash_a;
+        out[i + 1] = hash_b;
+    }
+
+    if (i < count) {
+        out[i] = CalculateFNV(reinterpret_cast<const uint8_t*>(keys[i].data()), keys[i].size());
+    }
+}
+
+uint64_t FNVHasher::Sum64(const std::vector<uint8_t>& data) const {
+    return CalculateFNV(data.data(), data.size());
+}
+
 uint64_t FNVHasher::Sum64(const std::string& data) const {
-    uint64_t hash = FNV_OFFSET_BASIS;
-    
-    for (char c : data) {
-        hash ^= static_cast<uint8_t>(c);
-        hash *= FNV_PRIME;
+    return CalculateFNV(reinterpret_cast<const uint8_t*>(data.data()), data.size());
+}
+
+uint64_t FNVHasher::Sum64(const uint8_t* data, size_t length) const {
+    return CalculateFNV(data, length);
+}
+
+void FNVHasher::Sum64Batch(const std::string* keys, size_t count, uint64_t* out) const {
+    CalculateFNVBatch(keys, count, out);
+}
+
+void FNVHasher::Sum64Batch(const std::string_view* keys, size_t count, uint64_t* out) const {
+    CalculateFNVBatch(keys, count, out);
+}
+
+// Helpers shared by XXH3Hasher and WyHasher
+namespace {
+
+// memcpy compiles to a single unaligned load; only big-endian hosts pay for a swap
+inline uint64_t ReadLE64(const uint8_t* p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    v = __builtin_bswap64(v);
+#endif
+    return v;
+}
+
+inline uint64_t ReadLE32(const uint8_t* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    v = __builtin_bswap32(v);
+#endif
+    return v;
+}
+
+inline void WriteLE64(uint8_t* p, uint64_t v) {
+    for (int i = 0; i < 8; ++i) {
+        p[i] = static_cast<uint8_t>(v >> (i * 8));
+    }
+}
+
+inline uint64_t Rotl64(uint64_t v, int r) {
+    return (v << r) | (v >> (64 - r));
+}
+
+inline uint64_t Swap32(uint64_t v) {
+    return ((v & 0xFFULL) << 24) | ((v & 0xFF00ULL) << 8) | ((v >> 8) & 0xFF00ULL) | ((v >> 24) & 0xFFULL);
+}
+
+inline uint64_t Swap64(uint64_t v) {
+    v = ((v & 0x00FF00FF00FF00FFULL) << 8) | ((v >> 8) & 0x00FF00FF00FF00FFULL);
+    v = ((v & 0x0000FFFF0000FFFFULL) << 16) | ((v >> 16) & 0x0000FFFF0000FFFFULL);
+    return (v << 32) | (v >> 32);
+}
+
+#if defined(__SIZEOF_INT128__)
+// __extension__ keeps -Wpedantic quiet about the non-standard type
+__extension__ typedef unsigned __int128 u128;
+#endif
+
+// Full 64x64 -> 128 bit multiply, returned as (lo, hi)
+inline void Mul128(uint64_t a, uint64_t b, uint64_t& lo, uint64_t& hi) {
+#if defined(__SIZEOF_INT128__)
+    u128 r = static_cast<u128>(a) * b;
+    lo = static_cast<uint64_t>(r);
+    hi = static_cast<uint64_t>(r >> 64);
+#else
+    uint64_t a_lo = a & 0xFFFFFFFFULL, a_hi = a >> 32;
+    uint64_t b_lo = b & 0xFFFFFFFFULL, b_hi = b >> 32;
+    uint64_t lo_lo = a_lo * b_lo;
+    uint64_t hi_lo = a_hi * b_lo;
+    uint64_t lo_hi = a_lo * b_hi;
+    uint64_t hi_hi = a_hi * b_hi;
+    uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFFULL) + lo_hi;
+    hi = (hi_lo >> 32) + (cross >> 32) + hi_hi;
+    lo = (cross << 32) | (lo_lo & 0xFFFFFFFFULL);
+#endif
+}
+
+inline uint64_t Mul128Fold64(uint64_t a, uint64_t b) {
+    uint64_t lo, hi;
+    Mul128(a, b, lo, hi);
+    return lo ^ hi;
+}
+
+// XXH3 .
+constexpr uint64_t XXH_PRIME32_1 = 0x9E3779B1ULL;
+constexpr uint64_t XXH_PRIME32_2 = 0x85EBCA77ULL;
+constexpr uint64_t XXH_PRIME32_3 = 0xC2B2AE3DULL;
+constexpr uint64_t XXH_PRIME64_1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t XXH_PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64_t XXH_PRIME64_3 = 0x165667B19E3779F9ULL;
+constexpr uint64_t XXH_PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+constexpr uint64_t XXH_PRIME64_5 = 0x27D4EB2F165667C5ULL;
+constexpr uint64_t XXH_PRIME_MX1 = 0x165667919E3779F9ULL;
+constexpr uint64_t XXH_PRIME_MX2 = 0x9FB21C651E98DF25ULL;
+
+constexpr size_t XXH3_SECRET_SIZE = 192;
+constexpr size_t XXH3_STRIPE_LEN = 64;
+constexpr size_t XXH3_SECRET_CONSUME_RATE = 8;
+constexpr size_t XXH3_ACC_NB = 8;
+constexpr size_t XXH3_MIDSIZE_MAX = 240;
+
+const uint8_t XXH3_DEFAULT_SECRET[XXH3_SECRET_SIZE] = {
+    0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+    0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+    0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+    0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+    0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+    0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+    0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+    0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+    0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+    0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+    0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+    0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e,
+};
+
+inline uint64_t XXH64Avalanche(uint64_t h) {
+    h ^= h >> 33;
+    h *= XXH_PRIME64_2;
+    h ^= h >> 29;
+    h *= XXH_PRIME64_3;
+    return h ^ (h >> 32);
+}
+
+inline uint64_t XXH3Avalanche(uint64_t h) {
+    h ^= h >> 37;
+    h *= XXH_PRIME_MX1;
+    return h ^ (h >> 32);
+}
+
+inline uint64_t XXH3Rrmxmx(uint64_t h, uint64_t len) {
+    h ^= Rotl64(h, 49) ^ Rotl64(h, 24);
+    h *= XXH_PRIME_MX2;
+    h ^= (h >> 35) + len;
+    h *= XXH_PRIME_MX2;
+    return h ^ (h >> 28);
+}
+
+inline uint64_t XXH3Mix16B(const uint8_t* input, const uint8_t* secret, uint64_t seed) {
+    return Mul128Fold64(ReadLE64(input) ^ (ReadLE64(secret) + seed),
+                        ReadLE64(input + 8) ^ (ReadLE64(secret + 8) - seed));
+}
+
+uint64_t XXH3Len0To16(const uint8_t* input, size_t len, const uint8_t* secret, uint64_t seed) {
+    if (len > 8) {
+        uint64_t bitflip1 = (ReadLE64(secret + 24) ^ ReadLE64(secret + 32)) + seed;
+        uint64_t bitflip2 = (ReadLE64(secret + 40) ^ ReadLE64(secret + 48)) - seed;
+        uint64_t input_lo = ReadLE64(input) ^ bitflip1;
+        uint64_t input_hi = ReadLE64(input + len - 8) ^ bitflip2;
+        uint64_t acc = len + Swap64(input_lo) + input_hi + Mul128Fold64(input_lo, input_hi);
+        return XXH3Avalanche(acc);
+    }
+    if (len >= 4) {
+        seed ^= Swap32(seed & 0xFFFFFFFFULL) << 32;
+        uint64_t input1 = ReadLE32(input);
+        uint64_t input2 = ReadLE32(input + len - 4);
+        uint64_t bitflip = (ReadLE64(secret + 8) ^ ReadLE64(secret + 16)) - seed;
+        uint64_t keyed = (input2 + (input1 << 32)) ^ bitflip;
+        return XXH3Rrmxmx(keyed, len);
+    }
+    if (len > 0) {
+        uint64_t combined = (static_cast<uint64_t>(input[0]) << 16) |
+                            (static_cast<uint64_t>(input[len >> 1]) << 24) |
+                            static_cast<uint64_t>(input[len - 1]) |
+                            (static_cast<uint64_t>(len) << 8);
+        uint64_t bitflip = (ReadLE32(secret) ^ ReadLE32(secret + 4)) + seed;
+        return XXH64Avalanche(combined ^ bitflip);
+    }
+    return XXH64Avalanche(seed ^ ReadLE64(secret + 56) ^ ReadLE64(secret + 64));
+}
+
+uint64_t XXH3Len17To128(const uint8_t* input, size_t len, const uint8_t* secret, uint64_t seed) {
+    uint64_t acc = len * XXH_PRIME64_1;
+    if (len > 32) {
+        if (len > 64) {
+            if (len > 96) {
+                acc += XXH3Mix16B(input + 48, secret + 96, seed);
+                acc += XXH3Mix16B(input + len - 64, secret + 112, seed);
+            }
+            acc += XXH3Mix16B(input + 32, secret + 64, seed);
+            acc += XXH3Mix16B(input + len - 48, secret + 80, seed);
+        }
+        acc += XXH3Mix16B(input + 16, secret + 32, seed);
+        acc += XXH3Mix16B(input + len - 32, secret + 48, seed);
+    }
+    acc += XXH3Mix16B(input, secret, seed);
+    acc += XXH3Mix16B(input + len - 16, secret + 16, seed);
+    return XXH3Avalanche(acc);
+}
+
+uint64_t XXH3Len129To240(const uint8_t* input, size_t len, const uint8_t* secret, uint64_t seed) {
+    const size_t midsize_start_offset = 3;
+    const size_t midsize_last_offset = 17;
+    const size_t secret_size_min = 136;
+
+    uint64_t acc = len * XXH_PRIME64_1;
+    size_t rounds = len / 16;
+    for (size_t i = 0; i < 8; ++i) {
+        acc += XXH3Mix16B(input + 16 * i, secret + 16 * i, seed);
+    }
+    acc = XXH3Avalanche(acc);
+
+    for (size_t i = 8; i < rounds; ++i) {
+        acc += XXH3Mix16B(input + 16 * i, secret + 16 * (i - 8) + midsize_start_offset, seed);
+    }
+    acc += XXH3Mix16B(input + len - 16, secret + secret_size_min - midsize_last_offset, seed);
+    return XXH3Avalanche(acc);
+}
+
+#if defined(__SSE2__) && defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+
+// Two lanes per register, as the reference SSE2 path does; baseline on x86-64
+inline void XXH3Accumulate512(uint64_t* acc, const uint8_t* input, const uint8_t* secret) {
+    for (size_t i = 0; i < XXH3_ACC_NB / 2; ++i) {
+        __m128i* lanes = reinterpret_cast<__m128i*>(acc) + i;
+        __m128i data_val = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input) + i);
+        __m128i data_key = _mm_xor_si128(data_val, _mm_loadu_si128(reinterpret_cast<const __m128i*>(secret) + i));
+        __m128i product = _mm_mul_epu32(data_key, _mm_shuffle_epi32(data_key, _MM_SHUFFLE(0, 3, 0, 1)));
+        __m128i swapped = _mm_shuffle_epi32(data_val, _MM_SHUFFLE(1, 0, 3, 2));
+        _mm_storeu_si128(lanes, _mm_add_epi64(product, _mm_add_epi64(_mm_loadu_si128(lanes), swapped)));
+    }
+}
+
+inline void XXH3Scramble(uint64_t* acc, const uint8_t* secret) {
+    const __m128i prime = _mm_set1_epi32(static_cast<int>(XXH_PRIME32_1));
+    for (size_t i = 0; i < XXH3_ACC_NB / 2; ++i) {
+        __m128i* lanes = reinterpret_cast<__m128i*>(acc) + i;
+        __m128i a = _mm_loadu_si128(lanes);
+        a = _mm_xor_si128(a, _mm_srli_epi64(a, 47));
+        a = _mm_xor_si128(a, _mm_loadu_si128(reinterpret_cast<const __m128i*>(secret) + i));
+        __m128i lo = _mm_mul_epu32(a, prime);
+        __m128i hi = _mm_mul_epu32(_mm_shuffle_epi32(a, _MM_SHUFFLE(0, 3, 0, 1)), prime);
+        _mm_storeu_si128(lanes, _mm_add_epi64(lo, _mm_slli_epi64(hi, 32)));
+    }
+}
+
+#else
+
+inline void XXH3Accumulate512(uint64_t* acc, const uint8_t* input, const uint8_t* secret) {
+    for (size_t i = 0; i < XXH3_ACC_NB; ++i) {
+        uint64_t data_val = ReadLE64(input + 8 * i);
+        uint64_t data_key = data_val ^ ReadLE64(secret + 8 * i);
+        acc[i ^ 1] += data_val;
+        acc[i] += (data_key & 0xFFFFFFFFULL) * (data_key >> 32);
+    }
+}
+
+inline void XXH3Scramble(uint64_t* acc, const uint8_t* secret) {
+    for (size_t i = 0; i < XXH3_ACC_NB; ++i) {
+        uint64_t a = acc[i];
+        a ^= a >> 47;
+        a ^= ReadLE64(secret + 8 * i);
+        acc[i] = a * XXH_PRIME32_1;
+    }
+}
+
+#endif
+
+uint64_t XXH3HashLong(const uint8_t* input, size_t len, const uint8_t* secret) {
+    uint64_t acc[XXH3_ACC_NB] = {XXH_PRIME32_3, XXH_PRIME64_1, XXH_PRIME64_2, XXH_PRIME64_3,
+                                 XXH_PRIME64_4, XXH_PRIME32_2, XXH_PRIME64_5, XXH_PRIME32_1};
+
+    const size_t stripes_per_block = (XXH3_SECRET_SIZE - XXH3_STRIPE_LEN) / XXH3_SECRET_CONSUME_RATE;
+    const size_t block_len = XXH3_STRIPE_LEN * stripes_per_block;
+    const size_t blocks = (len - 1) / block_len;
+
+    for (size_t n = 0; n < blocks; ++n) {
+        for (size_t s = 0; s < stripes_per_block; ++s) {
+            XXH3Accumulate512(acc, input + n * block_len + s * XXH3_STRIPE_LEN,
+                              secret + s * XXH3_SECRET_CONSUME_RATE);
+        }
+        XXH3Scramble(acc, secret + XXH3_SECRET_SIZE - XXH3_STRIPE_LEN);
+    }
+
+    // Last partial block, then the final stripe which may overlap it
+    const size_t stripes = ((len - 1) - block_len * blocks) / XXH3_STRIPE_LEN;
+    for (size_t s = 0; s < stripes; ++s) {
+        XXH3Accumulate512(acc, input + blocks * block_len + s * XXH3_STRIPE_LEN,
+                          secret + s * XXH3_SECRET_CONSUME_RATE);
+    }
+    const size_t last_acc_start = 7;
+    XXH3Accumulate512(acc, input + len - XXH3_STRIPE_LEN,
+                      secret + XXH3_SECRET_SIZE - XXH3_STRIPE_LEN - last_acc_start);
+
+    const size_t merge_accs_start = 11;
+    uint64_t result = len * XXH_PRIME64_1;
+    for (size_t i = 0; i < 4; ++i) {
+        const uint8_t* s = secret + merge_accs_start + 16 * i;
+        result += Mul128Fold64(acc[2 * i] ^ ReadLE64(s), acc[2 * i + 1] ^ ReadLE64(s + 8));
+    }
+    return XXH3Avalanche(result);
+}
+
+uint64_t CalculateXXH3(const uint8_t* input, size_t len, const uint8_t* secret, uint64_t seed) {
+    if (len <= 16) {
+        return XXH3Len0To16(input, len, XXH3_DEFAULT_SECRET, seed);
+    }
+    if (len <= 128) {
+        return XXH3Len17To128(input, len, XXH3_DEFAULT_SECRET, seed);
+    }
+    if (len <= XXH3_MIDSIZE_MAX) {
+        return XXH3Len129To240(input, len, XXH3_DEFAULT_SECRET, seed);
+    }
+    // Long inputs use the seed-derived secret instead of mixing in the seed
+    return XXH3HashLong(input, len, secret);
+}
+
+// wyhash .
+const uint64_t WY_SECRET[4] = {0x2d358dccaa6c78a5ULL, 0x8bb84b93962eacc9ULL,
+                               0x4b33a62ed433d4a3ULL, 0x4d5a2da51de1aa47ULL};
+
+inline uint64_t WyMix(uint64_t a, uint64_t b) {
+    uint64_t lo, hi;
+    Mul128(a, b, lo, hi);
+    return lo ^ hi;
+}
+
+inline uint64_t WyRead3(const uint8_t* p, size_t k) {
+    return (static_cast<uint64_t>(p[0]) << 16) | (static_cast<uint64_t>(p[k >> 1]) << 8) | p[k - 1];
+}
+
+uint64_t CalculateWyhash(const uint8_t* p, size_t len, uint64_t seed) {
+    seed ^= WyMix(seed ^ WY_SECRET[0], WY_SECRET[1]);
+    uint64_t a, b;
+
+    if (len <= 16) {
+        if (len >= 4) {
+            a = (ReadLE32(p) << 32) | ReadLE32(p + ((len >> 3) << 2));
+            b = (ReadLE32(p + len - 4) << 32) | ReadLE32(p + len - 4 - ((len >> 3) << 2));
+        } else if (len > 0) {
+            a = WyRead3(p, len);
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        size_t i = len;
+        if (i > 48) {
+            uint64_t see1 = seed, see2 = seed;
+            do {
+                seed = WyMix(ReadLE64(p) ^ WY_SECRET[1], ReadLE64(p + 8) ^ seed);
+                see1 = WyMix(ReadLE64(p + 16) ^ WY_SECRET[2], ReadLE64(p + 24) ^ see1);
+                see2 = WyMix(ReadLE64(p + 32) ^ WY_SECRET[3], ReadLE64(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16) {
+            seed = WyMix(ReadLE64(p) ^ WY_SECRET[1], ReadLE64(p + 8) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+        a = ReadLE64(p + i - 16);
+        b = ReadLE64(p + i - 8);
+    }
+
+    a ^= WY_SECRET[1];
+    b ^= seed;
+    Mul128(a, b, a, b);
+    return WyMix(a ^ WY_SECRET[0] ^ len, b ^ WY_SECRET[1]);
+}
+
+} // namespace
+
+// XXH3Hasher .
+XXH3Hasher::XXH3Hasher(uint64_t seed) : seed_(seed) {
+    for (size_t i = 0; i < XXH3_SECRET_SIZE / 16; ++i) {
+        WriteLE64(secret_ + 16 * i, ReadLE64(XXH3_DEFAULT_SECRET + 16 * i) + seed);
+        WriteLE64(secret_ + 16 * i + 8, ReadLE64(XXH3_DEFAULT_SECRET + 16 * i + 8) - seed);
+    }
+}
+
+uint64_t XXH3Hasher::Sum64(const std::vector<uint8_t>& data) const {
+    return CalculateXXH3(data.data(), data.size(), secret_, seed_);
+}
+
+uint64_t XXH3Hasher::Sum64(const std::string& data) const {
+    return CalculateXXH3(reinterpret_cast<const uint8_t*>(data.data()), data.size(), secret_, seed_);
+}
+
+uint64_t XXH3Hasher::Sum64(const uint8_t* data, size_t length) const {
+    return CalculateXXH3(data, length, secret_, seed_);
+}
+
+void XXH3Hasher::Sum64Batch(const std::string* keys, size_t count, uint64_t* out) const {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = CalculateXXH3(reinterpret_cast<const uint8_t*>(keys[i].data()), keys[i].size(), secret_, seed_);
+    }
+}
+
+void XXH3Hasher::Sum64Batch(const std::string_view* keys, size_t count, uint64_t* out) const {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = CalculateXXH3(reinterpret_cast<const uint8_t*>(keys[i].data()), keys[i].size(), secret_, seed_);
+    }
+}
+
+// WyHasher .
+uint64_t WyHasher::Sum64(const std::vector<uint8_t>& data) const {
+    return CalculateWyhash(data.data(), data.size(), seed_);
+}
+
+uint64_t WyHasher::Sum64(const std::string& data) const {
+    return CalculateWyhash(reinterpret_cast<const uint8_t*>(data.data()), data.size(), seed_);
+}
+
+uint64_t WyHasher::Sum64(const uint8_t* data, size_t length) const {
+    return CalculateWyhash(data, length, seed_);
+}
+
+void WyHasher::Sum64Batch(const std::string* keys, size_t count, uint64_t* out) const {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = CalculateWyhash(reinterpret_cast<const uint8_t*>(keys[i].data()), keys[i].size(), seed_);
+    }
+}
+
+void WyHasher::Sum64Batch(const std::string_view* keys, size_t count, uint64_t* out) const {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = CalculateWyhash(reinterpret_cast<const uint8_t*>(keys[i].data()), keys[i].size(), seed_);
     }
-    
-    return hash;
 }
 
 std::unique_ptr<Hasher> CreateCRC64Hasher() {
@@ -77,4 +838,12 @@ std::unique_ptr<Hasher> CreateFNVHasher() {
     return std::make_unique<FNVHasher>();
 }
 
+std::unique_ptr<Hasher> CreateXXH3Hasher(uint64_t seed) {
+    return std::make_unique<XXH3Hasher>(seed);
+}
+
+std::unique_ptr<Hasher> CreateWyHasher(uint64_t seed) {
+    return std::make_unique<WyHasher>(seed);
+}
+
 } // namespace consistent
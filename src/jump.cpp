@@ -0,0 +1,200 @@
+#include "jump.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace consistent {
+
+JumpConsistent::JumpConsistent(const std::vector<std::shared_ptr<Member>>& members, std::unique_ptr<Hasher> hasher)
+    : hasher_(std::move(hasher)) {
+
+    if (!hasher_) {
+        throw std::invalid_argument("hasher cannot be null");
+    }
+
+    auto state = std::make_unique<State>();
+    for (const auto& member : members) {
+        auto same_name = [&](const std::shared_ptr<Member>& m) { return m->Name() == member->Name(); };
+        if (std::none_of(state->members.begin(), state->members.end(), same_name)) {
+            state->members.push_back(member);
+        }
+    }
+    state_.store(state.release(), std::memory_order_release);
+}
+
+JumpConsistent::~JumpConsistent() {
+    delete state_.load(std::memory_order_acquire);
+}
+
+void JumpConsistent::Publish(std::unique_ptr<State> next) {
+    const State* old = state_.exchange(next.release(), std::memory_order_seq_cst);
+
+    // Wait until no reader can still be looking at the old state
+    epoch_.Synchronize();
+    delete old;
+}
+
+int32_t JumpConsistent::JumpHash(uint64_t key, int32_t buckets) {
+    int64_t b = -1;
+    int64_t j = 0;
+    while (j < buckets) {
+        b = j;
+        key = key * 2862933555777941757ULL + 1;
+        j = static_cast<int64_t>((b + 1) * (static_cast<double>(1LL << 31) / static_cast<double>((key >> 33) + 1)));
+    }
+    return static_cast<int32_t>(b);
+}
+
+std::vector<PartitionMove> JumpConsistent::Add(std::shared_ptr<Member> member) {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    const State* current = state_.load(std::memory_order_acquire);
+
+    for (const auto& existing : current->members) {
+        if (existing->Name() == member->Name()) {
+            return {}; // Member already exists
+        }
+    }
+
+    // Only the new shard changes hands; the keys it takes come from all the others
+    std::vector<PartitionMove> moves = {{static_cast<int>(current->members.size()), nullptr, member}};
+    auto next = std::make_unique<State>(*current);
+    next->members.push_back(std::move(member));
+    Publish(std::move(next));
+    return moves;
+}
+
+std::vector<PartitionMove> JumpConsistent::Remove(const Member& member) {
+    return RemoveByName(member.Name());
+}
+
+std::vector<PartitionMove> JumpConsistent::RemoveByName(const std::string& name) {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    const State* current = state_.load(std::memory_order_acquire);
+
+    const auto& members = current->members;
+    auto it = std::find_if(members.begin(), members.end(),
+                           [&](const std::shared_ptr<Member>& m) { return m->Name() == name; });
+    if (it == members.end()) {
+        return {}; // Member doesn't exist
+    }
+
+    // Every shard from the removed one on is renumbered down by one
+    std::vector<PartitionMove> moves;
+    for (size_t shard = it - members.begin(); shard < members.size(); ++shard) {
+        moves.push_back({static_cast<int>(shard), members[shard],
+                         shard + 1 < members.size() ? members[shard + 1] : nullptr});
+    }
+
+    auto next = std::make_unique<State>();
+    next->members.reserve(members.size() - 1);
+    next->members.insert(next->members.end(), members.begin(), it);
+    next->members.insert(next->members.end(), it + 1, members.end());
+    Publish(std::move(next));
+    return moves;
+}
+
+std::shared_ptr<Member> JumpConsistent::LocateKey(const std::vector<uint8_t>& key) const {
+    return LocateHash(hasher_->Sum64(key));
+}
+
+std::shared_ptr<Member> JumpConsistent::LocateKey(const std::string& key) const {
+    return LocateHash(hasher_->Sum64(key));
+}
+
+std::shared_ptr<Member> JumpConsistent::LocateKey(std::string_view key) const {
+    return LocateHash(hasher_->Sum64(reinterpret_cast<const uint8_t*>(key.data()), key.size()));
+}
+
+std::shared_ptr<Member> JumpConsistent::LocateKey(const char* key) const {
+    return LocateKey(std::string_view(key));
+}
+
+std::shared_ptr<Member> JumpConsistent::LocateKey(const uint8_t* data, size_t length) const {
+    return LocateHash(hasher_->Sum64(data, length));
+}
+
+std::shared_ptr<Member> JumpConsistent::LocateHash(uint64_t hkey) const {
+    auto guard = epoch_.Read();
+    const State* state = state_.load(std::memory_order_seq_cst);
+
+    if (state->members.empty()) {
+        return nullptr;
+    }
+    return state->members[JumpHash(hkey, static_cast<int32_t>(state->members.size()))];
+}
+
+std::vector<std::shared_ptr<Member>> JumpConsistent::GetClosestN(const std::vector<uint8_t>& key, int count) const {
+    if (count <= 0) {
+        return {};
+    }
+    return GetClosestNByHash(hasher_->Sum64(key), count);
+}
+
+std::vector<std::shared_ptr<Member>> JumpConsistent::GetClosestN(const std::string& key, int count) const {
+    if (count <= 0) {
+        return {};
+    }
+    return GetClosestNByHash(hasher_->Sum64(key), count);
+}
+
+std::vector<std::shared_ptr<Member>> JumpConsistent::GetClosestN(std::string_view key, int count) const {
+    if (count <= 0) {
+        return {};
+    }
+    return GetClosestNByHash(hasher_->Sum64(reinterpret_cast<const uint8_t*>(key.data()), key.size()), count);
+}
+
+std::vector<std::shared_ptr<Member>> JumpConsistent::GetClosestN(const char* key, int count) const {
+    return GetClosestN(std::string_view(key), count);
+}
+
+std::vector<std::shared_ptr<Member>> JumpConsistent::GetClosestN(const uint8_t* data, size_t length, int count) const {
+    if (count <= 0) {
+        return {};
+    }
+    return GetClosestNByHash(hasher_->Sum64(data, length), count);
+}
+
+int JumpConsistent::GetClosestN(std::string_view key, int count, Member** out) const {
+    if (count <= 0) {
+        return 0;
+    }
+    uint64_t hkey = hasher_->Sum64(reinterpret_cast<const uint8_t*>(key.data()), key.size());
+
+    auto guard = epoch_.Read();
+    return GetClosestN(*state_.load(std::memory_order_seq_cst), hkey, count, out);
+}
+
+std::vector<std::shared_ptr<Member>> JumpConsistent::GetClosestNByHash(uint64_t hkey, int count) const {
+    auto guard = epoch_.Read();
+    const State* state = state_.load(std::memory_order_seq_cst);
+
+    std::vector<Member*> raw(count);
+    int found = GetClosestN(*state, hkey, count, raw.data());
+
+    std::vector<std::shared_ptr<Member>> result;
+    result.reserve(found);
+    for (int i = 0; i < found; ++i) {
+        result.push_back(raw[i]->shared_from_this());
+    }
+    return result;
+}
+
+int JumpConsistent::GetClosestN(const State& state, uint64_t hkey, int count, Member** out) {
+    int32_t shards = static_cast<int32_t>(state.members.size());
+    if (count > shards || shards == 0) {
+        throw InsufficientMemberCountException("insufficient number of members");
+    }
+
+    int32_t shard = JumpHash(hkey, shards);
+    for (int i = 0; i < count; ++i) {
+        out[i] = state.members[(shard + i) % shards].get();
+    }
+    return count;
+}
+
+std::vector<std::shared_ptr<Member>> JumpConsistent::GetMembers() const {
+    auto guard = epoch_.Read();
+    return state_.load(std::memory_order_seq_cst)->members;
+}
+
+} // namespace consistent
@@ -0,0 +1,285 @@
+#include "maglev.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace consistent {
+
+namespace {
+
+bool IsPrime(uint32_t n) {
+    if (n < 2) {
+        return false;
+    }
+    for (uint64_t d = 2; d * d <= n; ++d) {
+        if (n % d == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+MaglevConsistent::MaglevConsistent(const std::vector<std::shared_ptr<Member>>& members,
+                                   std::unique_ptr<Hasher> hasher, uint32_t table_size)
+    : hasher_(std::move(hasher)), table_size_(table_size) {
+
+    if (!hasher_) {
+        throw std::invalid_argument("hasher cannot be null");
+    }
+    if (!IsPrime(table_size_)) {
+        throw std::invalid_argument("table size must be prime");
+    }
+
+    auto state = std::make_unique<State>();
+    for (const auto& member : members) {
+        auto same_name = [&](const std::shared_ptr<Member>& m) { return m->Name() == member->Name(); };
+        if (std::none_of(state->members.begin(), state->members.end(), same_name)) {
+            state->members.push_back(member);
+        }
+    }
+    if (state->members.size() > table_size_) {
+        throw std::invalid_argument("table size must not be smaller than the member count");
+    }
+    Populate(*state);
+    state_.store(state.release(), std::memory_order_release);
+}
+
+MaglevConsistent::~MaglevConsistent() {
+    delete state_.load(std::memory_order_acquire);
+}
+
+void MaglevConsistent::Publish(std::unique_ptr<State> next) {
+    const State* old = state_.exchange(next.release(), std::memory_order_seq_cst);
+
+    // Wait until no reader can still be looking at the old state
+    epoch_.Synchronize();
+    delete old;
+}
+
+void MaglevConsistent::Populate(State& state) const {
+    auto& members = state.members;
+    std::sort(members.begin(), members.end(),
+              [](const std::shared_ptr<Member>& a, const std::shared_ptr<Member>& b) { return a->Name() < b->Name(); });
+
+    state.table.clear();
+    if (members.empty()) {
+        return;
+    }
+
+    // Each member walks its own permutation of the table: offset + j * skip
+    std::vector<uint64_t> offsets(members.size());
+    std::vector<uint64_t> skips(members.size());
+    for (size_t i = 0; i < members.size(); ++i) {
+        const std::string& name = members[i]->Name();
+        offsets[i] = hasher_->Sum64(name + "#offset") % table_size_;
+        skips[i] = hasher_->Sum64(name + "#skip") % (table_size_ - 1) + 1;
+    }
+
+    // positions[i] is the next slot in member i's permutation
+    constexpr uint32_t EMPTY = UINT32_MAX;
+    state.table.assign(table_size_, EMPTY);
+    std::vector<uint64_t>& positions = offsets;
+    uint32_t filled = 0;
+
+    while (true) {
+        for (size_t i = 0; i < members.size(); ++i) {
+            while (state.table[positions[i]] != EMPTY) {
+                positions[i] = (positions[i] + skips[i]) % table_size_;
+            }
+            state.table[positions[i]] = static_cast<uint32_t>(i);
+            positions[i] = (positions[i] + skips[i]) % table_size_;
+
+            if (++filled == table_size_) {
+                return;
+            }
+        }
+    }
+}
+
+std::vector<PartitionMove> MaglevConsistent::Replace(const State& current, std::unique_ptr<State> next) {
+    auto owner = [](const State& state, size_t entry) {
+        return state.table.empty() ? nullptr : state.members[state.table[entry]];
+    };
+    std::vector<PartitionMove> moves;
+    for (size_t entry = 0; entry < table_size_; ++entry) {
+        std::shared_ptr<Member> from = owner(current, entry);
+        std::shared_ptr<Member> to = owner(*next, entry);
+        if (from != to) {
+            moves.push_back({static_cast<int>(entry), std::move(from), std::move(to)});
+        }
+    }
+    Publish(std::move(next));
+    return moves;
+}
+
+std::vector<PartitionMove> MaglevConsistent::Add(std::shared_ptr<Member> member) {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    const State* current = state_.load(std::memory_order_acquire);
+
+    for (const auto& existing : current->members) {
+        if (existing->Name() == member->Name()) {
+            return {}; // Member already exists
+        }
+    }
+    if (current->members.size() + 1 > table_size_) {
+        throw std::invalid_argument("table size must not be smaller than the member count");
+    }
+
+    auto next = std::make_unique<State>();
+    next->members = current->members;
+    next->members.push_back(std::move(member));
+    Populate(*next);
+    return Replace(*current, std::move(next));
+}
+
+std::vector<PartitionMove> MaglevConsistent::Remove(const Member& member) {
+    return RemoveByName(member.Name());
+}
+
+std::vector<PartitionMove> MaglevConsistent::RemoveByName(const std::string& name) {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    const State* current = state_.load(std::memory_order_acquire);
+
+    const auto& members = current->members;
+    auto it = std::find_if(members.begin(), members.end(),
+                           [&](const std::shared_ptr<Member>& m) { return m->Name() == name; });
+    if (it == members.end()) {
+        return {}; // Member doesn't exist
+    }
+
+    auto next = std::make_unique<State>();
+    next->members.reserve(members.size() - 1);
+    next->members.insert(next->members.end(), members.begin(), it);
+    next->members.insert(next->members.end(), it + 1, members.end());
+    Populate(*next);
+    return Replace(*current, std::move(next));
+}
+
+std::shared_ptr<Member> MaglevConsistent::LocateKey(const std::vector<uint8_t>& key) const {
+    return LocateHash(hasher_->Sum64(key));
+}
+
+std::shared_ptr<Member> MaglevConsistent::LocateKey(const std::string& key) const {
+    return LocateHash(hasher_->Sum64(key));
+}
+
+std::shared_ptr<Member> MaglevConsistent::LocateKey(std::string_view key) const {
+    return LocateHash(hasher_->Sum64(reinterpret_cast<const uint8_t*>(key.data()), key.size()));
+}
+
+std::shared_ptr<Member> MaglevConsistent::LocateKey(const char* key) const {
+    return LocateKey(std::string_view(key));
+}
+
+std::shared_ptr<Member> MaglevConsistent::LocateKey(const uint8_t* data, size_t length) const {
+    return LocateHash(hasher_->Sum64(data, length));
+}
+
+std::shared_ptr<Member> MaglevConsistent::LocateHash(uint64_t hkey) const {
+    auto guard = epoch_.Read();
+    const State* state = state_.load(std::memory_order_seq_cst);
+
+    if (state->table.empty()) {
+        return nullptr;
+    }
+    return state->members[state->table[hkey % table_size_]];
+}
+
+std::vector<std::shared_ptr<Member>> MaglevConsistent::GetClosestN(const std::vector<uint8_t>& key, int count) const {
+    if (count <= 0) {
+        return {};
+    }
+    return GetClosestNByHash(hasher_->Sum64(key), count);
+}
+
+std::vector<std::shared_ptr<Member>> MaglevConsistent::GetClosestN(const std::string& key, int count) const {
+    if (count <= 0) {
+        return {};
+    }
+    return GetClosestNByHash(hasher_->Sum64(key), count);
+}
+
+std::vector<std::shared_ptr<Member>> MaglevConsistent::GetClosestN(std::string_view key, int count) const {
+    if (count <= 0) {
+        return {};
+    }
+    return GetClosestNByHash(hasher_->Sum64(reinterpret_cast<const uint8_t*>(key.data()), key.size()), count);
+}
+
+std::vector<std::shared_ptr<Member>> MaglevConsistent::GetClosestN(const char* key, int count) const {
+    return GetClosestN(std::string_view(key), count);
+}
+
+std::vector<std::shared_ptr<Member>> MaglevConsistent::GetClosestN(const uint8_t* data, size_t length,
+                                                                   int count) const {
+    if (count <= 0) {
+        return {};
+    }
+    return GetClosestNByHash(hasher_->Sum64(data, length), count);
+}
+
+int MaglevConsistent::GetClosestN(std::string_view key, int count, Member** out) const {
+    if (count <= 0) {
+        return 0;
+    }
+    uint64_t hkey = hasher_->Sum64(reinterpret_cast<const uint8_t*>(key.data()), key.size());
+
+    auto guard = epoch_.Read();
+    return GetClosestN(*state_.load(std::memory_order_seq_cst), hkey, count, out);
+}
+
+std::vector<std::shared_ptr<Member>> MaglevConsistent::GetClosestNByHash(uint64_t hkey, int count) const {
+    auto guard = epoch_.Read();
+    const State* state = state_.load(std::memory_order_seq_cst);
+
+    std::vector<Member*> raw(count);
+    int found = GetClosestN(*state, hkey, count, raw.data());
+
+    std::vector<std::shared_ptr<Member>> result;
+    result.reserve(found);
+    for (int i = 0; i < found; ++i) {
+        result.push_back(raw[i]->shared_from_this());
+    }
+    return result;
+}
+
+int MaglevConsistent::GetClosestN(const State& state, uint64_t hkey, int count, Member** out) const {
+    if (count > static_cast<int>(state.members.size()) || state.table.empty()) {
+        throw InsufficientMemberCountException("insufficient number of members");
+    }
+
+    // Every member owns at least one entry, so the walk finds count of them
+    int found = 0;
+    for (uint64_t entry = hkey % table_size_; found < count; entry = entry + 1 < table_size_ ? entry + 1 : 0) {
+        Member* member = state.members[state.table[entry]].get();
+        if (std::find(out, out + found, member) == out + found) {
+            out[found++] = member;
+        }
+    }
+    return found;
+}
+
+std::vector<std::shared_ptr<Member>> MaglevConsistent::GetMembers() const {
+    auto guard = epoch_.Read();
+    return state_.load(std::memory_order_seq_cst)->members;
+}
+
+std::unordered_map<std::string, double> MaglevConsistent::LoadDistribution() const {
+    auto guard = epoch_.Read();
+    const State* state = state_.load(std::memory_order_seq_cst);
+
+    std::vector<uint32_t> entries(state->members.size(), 0);
+    for (uint32_t owner : state->table) {
+        entries[owner]++;
+    }
+
+    std::unordered_map<std::string, double> result;
+    result.reserve(state->members.size());
+    for (size_t i = 0; i < state->members.size(); ++i) {
+        result[state->members[i]->Name()] = entries[i];
+    }
+    return result;
+}
+
+} // namespace consistent
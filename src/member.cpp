@@ -3,18 +3,34 @@
 
 namespace consistent {
 
-GatewayMember::GatewayMember(const std::string& id, const std::string& host, int port)
-    : id_(id), host_(host), port_(port) {
+const std::string& Member::Name() const {
+    std::call_once(cached_name_once_, [this] { cached_name_ = String(); });
+    return cached_name_;
 }
 
-std::string GatewayMember::String() const {
+GatewayMember::GatewayMember(const std::string& id, const std::string& host, int port, double weight)
+    : id_(id), host_(host), port_(port), weight_(weight) {
+    // The fields never change, so build both strings once
     std::ostringstream oss;
-    oss << id_ << ":" << host_ << ":" << port_;
-    return oss.str();
+    oss << host_ << ":" << port_;
+    address_ = oss.str();
+    name_ = id_ + ":" + address_;
+}
+
+std::string GatewayMember::String() const {
+    return name_;
+}
+
+const std::string& GatewayMember::Name() const {
+    return name_;
 }
 
 std::unique_ptr<Member> GatewayMember::Clone() const {
-    return std::make_unique<GatewayMember>(id_, host_, port_);
+    return std::make_unique<GatewayMember>(id_, host_, port_, weight_);
+}
+
+double GatewayMember::Weight() const {
+    return weight_;
 }
 
 const std::string& GatewayMember::GetID() const {
@@ -29,10 +45,8 @@ int GatewayMember::GetPort() const {
     return port_;
 }
 
-std::string GatewayMember::GetAddress() const {
-    std::ostringstream oss;
-    oss << host_ << ":" << port_;
-    return oss.str();
+const std::string& GatewayMember::GetAddress() const {
+    return address_;
 }
 
 } // namespace consistent
@@ -0,0 +1,204 @@
+#include "placement.h"
+#include "consistent.h"
+#include <cmath>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+
+namespace consistent {
+
+uint32_t SlotTable::AcquireSlot(Member* member, const std::string& name, uint64_t name_hash, double weight) {
+    auto free_slot = std::find(member_table.begin(), member_table.end(), nullptr);
+    uint32_t slot = static_cast<uint32_t>(std::distance(member_table.begin(), free_slot));
+    if (free_slot == member_table.end()) {
+        member_table.push_back(nullptr);
+        names.emplace_back();
+        name_hashes.push_back(0);
+        weights.push_back(0);
+    }
+    member_table[slot] = member;
+    names[slot] = name;
+    name_hashes[slot] = name_hash;
+    weights[slot] = weight;
+    return slot;
+}
+
+uint32_t SlotTable::ReleaseSlot(Member* member) {
+    auto slot = std::find(member_table.begin(), member_table.end(), member);
+    if (slot == member_table.end()) {
+        return NO_OWNER;
+    }
+    uint32_t idx = static_cast<uint32_t>(std::distance(member_table.begin(), slot));
+    member_table[idx] = nullptr;
+    names[idx].clear();
+    weights[idx] = 0;
+    return idx;
+}
+
+void ValidateWeight(double weight) {
+    if (!(weight > 0) || !std::isfinite(weight)) {
+        throw std::invalid_argument("member weight must be positive and finite");
+    }
+}
+
+int VirtualNodeCount(int replication_factor, double weight) {
+    return std::max(1, static_cast<int>(std::lround(replication_factor * weight)));
+}
+
+void BuildVirtualNodeKey(const std::string& name, int index, std::vector<uint8_t>& key) {
+    std::string index_str = std::to_string(index);
+    key.clear();
+    key.reserve(name.size() + index_str.size());
+    key.insert(key.end(), name.begin(), name.end());
+    key.insert(key.end(), index_str.begin(), index_str.end());
+}
+
+void ValidateLoadBound(uint64_t partition_count, size_t member_count, double load, int replication_factor) {
+    if (member_count == 0) {
+        return; // Empty ring is valid
+    }
+
+    double avg_load = static_cast<double>(partition_count) / member_count * load;
+    double max_load = std::ceil(avg_load);
+
+    if (max_load > replication_factor * 2.0) {
+        std::ostringstream oss;
+        oss << "configuration may cause distribution issues: partitionCount=" << partition_count
+            << ", memberCount=" << member_count << ", load=" << load << " results in avgLoad=" << max_load
+            << " per member";
+        throw std::invalid_argument(oss.str());
+    }
+}
+
+ScratchVector<double> LoadCaps(const SlotTable& slots, uint64_t partition_count, double load, bool ceiled,
+                               std::pmr::memory_resource* scratch) {
+    double total_weight = 0;
+    for (size_t slot = 0; slot < slots.member_table.size(); ++slot) {
+        if (slots.member_table[slot]) {
+            total_weight += slots.weights[slot];
+        }
+    }
+
+    ScratchVector<double> caps(slots.member_table.size(), 0.0, scratch);
+    for (size_t slot = 0; slot < slots.member_table.size(); ++slot) {
+        if (slots.member_table[slot]) {
+            double cap = static_cast<double>(partition_count) * slots.weights[slot] / total_weight * load;
+            caps[slot] = ceiled ? std::ceil(cap) : cap;
+        }
+    }
+    return caps;
+}
+
+ScratchVector<uint32_t> PartitionOrder(uint64_t partition_count, const TrafficBound& bound,
+                                       std::pmr::memory_resource* scratch) {
+    ScratchVector<uint32_t> order(partition_count, scratch);
+    std::iota(order.begin(), order.end(), 0);
+    if (bound.Active()) {
+        std::stable_sort(order.begin(), order.end(),
+                         [&](uint32_t a, uint32_t b) { return bound.traffic[a] > bound.traffic[b]; });
+    }
+    return order;
+}
+
+uint32_t FindOwnerWithCapacity(const Ring& ring, const std::vector<uint32_t>& loads,
+                               const ScratchVector<double>& caps, const TrafficBound& bound, uint64_t part_id,
+                               size_t idx, uint32_t skip, uint64_t& probes) {
+    size_t ring_size = ring.Size();
+    size_t fallback = ring_size;
+
+    for (size_t count = 1;; ++count) {
+        if (count >= ring_size && fallback != ring_size) {
+            probes += count;
+            return ring.Owner(fallback);
+        }
+        if (count >= ring_size) {
+            size_t members = std::count_if(caps.begin(), caps.end(), [](double cap) { return cap > 0; });
+            std::ostringstream oss;
+            oss << "failed to assign partition " << part_id << " (members=" << members
+                << ", virtualNodes=" << ring_size << ")";
+            throw InsufficientSpaceException(oss.str());
+        }
+
+        uint32_t owner = ring.Owner(idx);
+        if (owner != skip && loads[owner] + 1 <= caps[owner]) {
+            if (bound.Fits(owner, part_id)) {
+                probes += count;
+                return owner;
+            }
+            if (fallback == ring_size) {
+                fallback = idx;
+            }
+        }
+
+        idx++;
+        if (idx >= ring_size) {
+            idx = 0;
+        }
+    }
+}
+
+uint64_t AssignPartitions(const Ring& ring, const ScratchVector<uint32_t>& starts,
+                          const ScratchVector<uint32_t>& order, const ScratchVector<double>& caps,
+                          TrafficBound& bound, std::vector<uint32_t>& partitions, std::vector<uint32_t>& loads,
+                          MoveLog* log) {
+    partitions.assign(order.size(), NO_OWNER);
+    loads.assign(caps.size(), 0);
+    if (bound.Active()) {
+        std::fill(bound.assigned.begin(), bound.assigned.end(), 0.0);
+    }
+
+    // Loads depend on every earlier assignment, so this part stays serial
+    uint64_t probes = 0;
+    for (uint32_t part_id : order) {
+        uint32_t owner = FindOwnerWithCapacity(ring, loads, caps, bound, part_id, starts[part_id], NO_OWNER, probes);
+        partitions[part_id] = owner;
+        loads[owner]++;
+        if (bound.Active()) {
+            bound.assigned[owner] += bound.traffic[part_id];
+        }
+        if (log) {
+            log->Record(part_id, owner);
+        }
+    }
+    return probes;
+}
+
+void PartitionKeys::Sort() {
+    order_.resize(keys_.size());
+    std::iota(order_.begin(), order_.end(), 0);
+    std::sort(order_.begin(), order_.end(), [this](uint32_t a, uint32_t b) {
+        return keys_[a] < keys_[b] || (keys_[a] == keys_[b] && a < b);
+    });
+    sorted_.resize(keys_.size());
+    for (size_t i = 0; i < keys_.size(); ++i) {
+        sorted_[i] = keys_[order_[i]];
+    }
+}
+
+ScratchVector<uint32_t> PartitionKeys::FindStarts(const Ring& ring, WorkerPool& pool,
+                                                  std::pmr::memory_resource* scratch) const {
+    ScratchVector<uint32_t> starts(keys_.size(), scratch);
+    size_t ring_size = ring.Size();
+
+    // Partition hashes are swept in ascending order against the sorted ring,
+    // so each chunk needs one search to find where it begins
+    ParallelFor(keys_.size(), pool, [&](uint64_t begin, uint64_t end) {
+        if (begin >= end) {
+            return;
+        }
+        size_t idx = ring.FindStart(sorted_[begin]);
+        if (ring.Empty() || ring.Hash(idx) < sorted_[begin]) {
+            idx = ring_size; // Wrapped: every key from here on is past the last virtual node
+        }
+
+        for (uint64_t i = begin; i < end; ++i) {
+            while (idx < ring_size && ring.Hash(idx) < sorted_[i]) {
+                idx++;
+            }
+            starts[order_[i]] = static_cast<uint32_t>(idx < ring_size ? idx : 0);
+        }
+    });
+    return starts;
+}
+
+} // namespace consistent
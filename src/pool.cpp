@@ -0,0 +1,95 @@
+#include "pool.h"
+#include <algorithm>
+
+namespace consistent {
+
+WorkerPool::WorkerPool(int threads)
+    : threads_(threads > 0 ? threads : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()))) {
+    for (int index = 1; index < threads_; ++index) {
+        workers_.emplace_back(&WorkerPool::Work, this, index);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    start_cv_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+void WorkerPool::Run(uint64_t count, const std::function<void(uint64_t, uint64_t)>& fn) {
+    if (workers_.empty()) {
+        fn(0, count);
+        return;
+    }
+
+    std::lock_guard<std::mutex> run_lock(run_mutex_);
+    uint64_t chunk = (count + threads_ - 1) / threads_;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        fn_ = &fn;
+        count_ = count;
+        chunk_ = chunk;
+        pending_ = static_cast<int>(workers_.size());
+        error_ = nullptr;
+        generation_++;
+    }
+    start_cv_.notify_all();
+
+    std::exception_ptr error;
+    try {
+        fn(0, std::min(chunk, count));
+    } catch (...) {
+        error = std::current_exception();
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [&] { return pending_ == 0; });
+    fn_ = nullptr;
+    if (!error) {
+        error = error_;
+    }
+    lock.unlock();
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void WorkerPool::Work(int index) {
+    uint64_t seen = 0;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        start_cv_.wait(lock, [&] { return stop_ || generation_ != seen; });
+        if (stop_) {
+            return;
+        }
+        seen = generation_;
+        const auto& fn = *fn_;
+        uint64_t begin = chunk_ * index;
+        uint64_t end = std::min(begin + chunk_, count_);
+        lock.unlock();
+
+        std::exception_ptr error;
+        if (begin < end) {
+            try {
+                fn(begin, end);
+            } catch (...) {
+                error = std::current_exception();
+            }
+        }
+
+        lock.lock();
+        if (error && !error_) {
+            error_ = error;
+        }
+        if (--pending_ == 0) {
+            done_cv_.notify_one();
+        }
+    }
+}
+
+} // namespace consistent
@@ -0,0 +1,134 @@
+#include "ring.h"
+#include <algorithm>
+
+namespace consistent {
+
+void Ring::Insert(uint64_t hash, uint32_t owner) {
+    hashes_.push_back(hash);
+    owners_.push_back(owner);
+}
+
+void Ring::RemoveOwners(const std::vector<bool>& removed) {
+    size_t kept = 0;
+    for (size_t i = 0; i < hashes_.size(); ++i) {
+        if (owners_[i] < removed.size() && removed[owners_[i]]) {
+            continue;
+        }
+        hashes_[kept] = hashes_[i];
+        owners_[kept] = owners_[i];
+        kept++;
+    }
+    hashes_.resize(kept);
+    owners_.resize(kept);
+}
+
+void Ring::Build(std::pmr::memory_resource* scratch) {
+    struct Entry {
+        uint64_t hash;
+        uint32_t owner;
+        uint32_t order;
+    };
+
+    // Sort by hash; equal hashes keep insertion order so the last one can win
+    std::pmr::vector<Entry> entries(scratch);
+    entries.reserve(hashes_.size());
+    for (size_t i = 0; i < hashes_.size(); ++i) {
+        entries.push_back({hashes_[i], owners_[i], static_cast<uint32_t>(i)});
+    }
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return a.hash != b.hash ? a.hash < b.hash : a.order < b.order;
+    });
+
+    size_t kept = 0;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (i + 1 < entries.size() && entries[i + 1].hash == entries[i].hash) {
+            continue;
+        }
+        hashes_[kept] = entries[i].hash;
+        owners_[kept] = entries[i].owner;
+        kept++;
+    }
+    hashes_.resize(kept);
+    owners_.resize(kept);
+    BuildIndex();
+}
+
+bool Ring::Assign(std::vector<uint64_t> hashes, std::vector<uint32_t> owners) {
+    if (hashes.size() != owners.size()) {
+        return false;
+    }
+    for (size_t i = 1; i < hashes.size(); ++i) {
+        if (hashes[i - 1] >= hashes[i]) {
+            return false;
+        }
+    }
+
+    hashes_ = std::move(hashes);
+    owners_ = std::move(owners);
+    BuildIndex();
+    return true;
+}
+
+void Ring::BuildIndex() {
+    fences_.clear();
+    jump_.clear();
+    if (index_bits_ > 0) {
+        // jump_[b] is the first entry whose top bits are >= b
+        size_t buckets = size_t{1} << index_bits_;
+        jump_.resize(buckets + 1);
+        size_t idx = 0;
+        for (size_t bucket = 0; bucket < buckets; ++bucket) {
+            while (idx < hashes_.size() && (hashes_[idx] >> (64 - index_bits_)) < bucket) {
+                idx++;
+            }
+            jump_[bucket] = static_cast<uint32_t>(idx);
+        }
+        jump_[buckets] = static_cast<uint32_t>(hashes_.size());
+        return;
+    }
+
+    for (size_t i = 0; i < hashes_.size(); i += BLOCK_SIZE) {
+        fences_.push_back(hashes_[i]);
+    }
+}
+
+size_t Ring::FindStart(uint64_t key) const {
+    if (!jump_.empty()) {
+        // Every entry in the key's bucket shares its top bits, so the answer lies inside it
+        size_t bucket = key >> (64 - index_bits_);
+        auto begin = hashes_.begin() + jump_[bucket];
+        auto end = hashes_.begin() + jump_[bucket + 1];
+        size_t idx = std::distance(hashes_.begin(), std::lower_bound(begin, end, key));
+        return idx >= hashes_.size() ? 0 : idx;
+    }
+
+    if (fences_.empty()) {
+        return 0;
+    }
+
+    // Branchless lower bound over the fences
+    const uint64_t* base = fences_.data();
+    size_t n = fences_.size();
+    while (n > 1) {
+        size_t half = n / 2;
+        base = base[half] < key ? base + half : base;
+        n -= half;
+    }
+    size_t block = static_cast<size_t>(base - fences_.data()) + (*base < key);
+    if (block == 0) {
+        return 0;
+    }
+
+    // Every fence from block on is >= key, so the answer lies in block - 1
+    size_t begin = (block - 1) * BLOCK_SIZE;
+    size_t end = std::min(begin + BLOCK_SIZE, hashes_.size());
+    size_t below = 0;
+    for (size_t i = begin; i < end; ++i) {
+        below += hashes_[i] < key;
+    }
+
+    size_t idx = begin + below;
+    return idx >= hashes_.size() ? 0 : idx;
+}
+
+} // namespace consistent
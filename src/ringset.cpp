@@ -0,0 +1,264 @@
+#include "ringset.h"
+#include <algorithm>
+
+namespace consistent {
+
+RingSet::RingSet(const std::vector<std::shared_ptr<Member>>& members, std::unique_ptr<Hasher> hasher,
+                 int replication_factor, int distribution_threads)
+    : hasher_(std::move(hasher)), replication_factor_(replication_factor),
+      distribution_pool_(distribution_threads) {
+    if (!hasher_) {
+        throw std::invalid_argument("hasher cannot be null");
+    }
+    if (replication_factor_ <= 0) {
+        throw std::invalid_argument("replication factor must be positive");
+    }
+
+    auto state = std::make_unique<State>();
+    for (const auto& member : members) {
+        if (state->members.find(member->Name()) == state->members.end()) {
+            AddMember(*state, member);
+        }
+    }
+    state->ring.Build(&scratch_);
+    state_.store(state.release(), std::memory_order_release);
+}
+
+RingSet::~RingSet() {
+    delete state_.load(std::memory_order_acquire);
+}
+
+void RingSet::Publish(std::unique_ptr<State> next) {
+    const State* old = state_.exchange(next.release(), std::memory_order_seq_cst);
+
+    // Wait until no reader can still be looking at the old state
+    epoch_.Synchronize();
+    delete old;
+}
+
+void RingSet::AddMember(State& state, std::shared_ptr<Member> member) {
+    const std::string& name = member->Name();
+    double weight = member->Weight();
+    ValidateWeight(weight);
+
+    // Callers rebuild the ring once they are done adding
+    uint32_t slot = state.AcquireSlot(member.get(), name, hasher_->Sum64(name), weight);
+    InsertVirtualNodes(state.ring, *hasher_, name, VirtualNodeCount(replication_factor_, weight), slot);
+    state.members[name] = std::move(member);
+}
+
+ScratchVector<uint32_t> RingSet::FindStartIndices(const State& state, uint64_t partition_count) {
+    // Partition hashes depend only on the ID, so one table serves every tenant
+    partition_keys_.Grow(partition_count, *hasher_, distribution_pool_);
+    return partition_keys_.FindStarts(state.ring, distribution_pool_, &scratch_);
+}
+
+std::shared_ptr<const RingSet::Tenant> RingSet::Distribute(const State& state, uint64_t partition_count,
+                                                           double load, const ScratchVector<uint32_t>& starts,
+                                                           bool ceiled) const {
+    auto tenant = std::make_shared<Tenant>();
+    tenant->partition_count = partition_count;
+    tenant->load = load;
+    tenant->loads.assign(state.member_table.size(), 0);
+    if (state.members.empty()) {
+        return tenant;
+    }
+
+    // Tenants record no traffic, so only the partition count bound applies
+    TrafficBound bound;
+    ScratchVector<double> caps = LoadCaps(state, partition_count, load, ceiled, &scratch_);
+    AssignPartitions(state.ring, starts, PartitionOrder(partition_count, bound, &scratch_), caps, bound,
+                     tenant->partitions, tenant->loads, nullptr);
+    return tenant;
+}
+
+void RingSet::RedistributeAll(State& state) {
+    uint64_t max_partitions = 0;
+    for (const auto& tenant : state.tenants) {
+        if (tenant) {
+            max_partitions = std::max(max_partitions, tenant->partition_count);
+        }
+    }
+
+    auto starts = FindStartIndices(state, max_partitions);
+    for (auto& tenant : state.tenants) {
+        if (tenant) {
+            tenant = Distribute(state, tenant->partition_count, tenant->load, starts, true);
+        }
+    }
+}
+
+TenantID RingSet::AddTenant(int partition_count, double load) {
+    if (partition_count <= 0) {
+        throw std::invalid_argument("partition count must be positive");
+    }
+    if (!(load > 0)) {
+        throw std::invalid_argument("load must be positive");
+    }
+
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    scratch_.Reset();
+    const State* current = state_.load(std::memory_order_acquire);
+
+    ValidateLoadBound(partition_count, current->members.size(), load, replication_factor_);
+
+    auto next = std::make_unique<State>(*current);
+    auto starts = FindStartIndices(*next, partition_count);
+
+    // A new tenant keeps the fractional bound, like a newly built Consistent
+    next->tenants.push_back(Distribute(*next, partition_count, load, starts, false));
+    TenantID id = static_cast<TenantID>(next->tenants.size() - 1);
+    Publish(std::move(next));
+    return id;
+}
+
+void RingSet::RemoveTenant(TenantID tenant) {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    const State* current = state_.load(std::memory_order_acquire);
+    GetTenant(*current, tenant);
+
+    auto next = std::make_unique<State>(*current);
+    next->tenants[tenant].reset();
+    Publish(std::move(next));
+}
+
+size_t RingSet::TenantCount() const {
+    auto guard = epoch_.Read();
+    const State* state = state_.load(std::memory_order_seq_cst);
+    return std::count_if(state->tenants.begin(), state->tenants.end(), [](const auto& t) { return t != nullptr; });
+}
+
+void RingSet::Add(std::shared_ptr<Member> member) {
+    ApplyChanges({std::move(member)}, {});
+}
+
+void RingSet::Remove(const Member& member) {
+    RemoveByName(member.Name());
+}
+
+void RingSet::RemoveByName(const std::string& name) {
+    ApplyChanges({}, {name});
+}
+
+void RingSet::ApplyChanges(const std::vector<std::shared_ptr<Member>>& adds,
+                           const std::vector<std::string>& removes) {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    scratch_.Reset();
+    const State* current = state_.load(std::memory_order_acquire);
+
+    auto next = std::make_unique<State>(*current);
+    bool changed = false;
+
+    std::vector<bool> removed_slots(next->member_table.size(), false);
+    for (const auto& name : removes) {
+        auto existing = next->members.find(name);
+        if (existing == next->members.end()) {
+            continue; // Member doesn't exist
+        }
+        removed_slots[next->ReleaseSlot(existing->second.get())] = true;
+        next->members.erase(existing);
+        changed = true;
+    }
+    if (changed) {
+        next->ring.RemoveOwners(removed_slots);
+    }
+
+    for (const auto& member : adds) {
+        if (next->members.find(member->Name()) != next->members.end()) {
+            continue; // Member already exists
+        }
+        AddMember(*next, member);
+        changed = true;
+    }
+    if (!changed) {
+        return;
+    }
+
+    // One ring rebuild and one start-position pass for every tenant
+    next->ring.Build(&scratch_);
+    RedistributeAll(*next);
+    Publish(std::move(next));
+}
+
+const RingSet::Tenant& RingSet::GetTenant(const State& state, TenantID tenant) {
+    if (tenant >= state.tenants.size() || !state.tenants[tenant]) {
+        throw std::out_of_range("unknown tenant " + std::to_string(tenant));
+    }
+    return *state.tenants[tenant];
+}
+
+std::shared_ptr<Member> RingSet::LocateKey(TenantID tenant, std::string_view key) const {
+    return LocateHash(tenant, hasher_->Sum64(key));
+}
+
+std::shared_ptr<Member> RingSet::LocateKey(TenantID tenant, const uint8_t* data, size_t length) const {
+    return LocateHash(tenant, hasher_->Sum64(data, length));
+}
+
+std::shared_ptr<Member> RingSet::LocateHash(TenantID tenant, uint64_t hkey) const {
+    auto guard = epoch_.Read();
+    const State* state = state_.load(std::memory_order_seq_cst);
+    const Tenant& t = GetTenant(*state, tenant);
+
+    if (t.partitions.empty()) {
+        return nullptr;
+    }
+    return state->member_table[t.partitions[hkey % t.partition_count]]->shared_from_this();
+}
+
+std::vector<std::shared_ptr<Member>> RingSet::GetClosestN(TenantID tenant, std::string_view key, int count) const {
+    if (count <= 0) {
+        return {};
+    }
+    uint64_t hkey = hasher_->Sum64(key);
+
+    auto guard = epoch_.Read();
+    const State* state = state_.load(std::memory_order_seq_cst);
+    const Tenant& t = GetTenant(*state, tenant);
+
+    if (count > static_cast<int>(state->members.size()) || t.partitions.empty()) {
+        throw InsufficientMemberCountException("insufficient number of members");
+    }
+
+    // Walk from the owner's name hash, as BasicConsistent does
+    uint32_t owner = t.partitions[hkey % t.partition_count];
+    std::vector<Member*> found(count);
+    found.resize(WalkClosestN(state->ring, state->member_table, state->ring.FindStart(state->name_hashes[owner]),
+                              count, found.data()));
+
+    std::vector<std::shared_ptr<Member>> result;
+    result.reserve(found.size());
+    for (Member* member : found) {
+        result.push_back(member->shared_from_this());
+    }
+    return result;
+}
+
+std::vector<std::shared_ptr<Member>> RingSet::GetMembers() const {
+    auto guard = epoch_.Read();
+    const State* state = state_.load(std::memory_order_seq_cst);
+
+    std::vector<std::shared_ptr<Member>> result;
+    result.reserve(state->members.size());
+    for (const auto& [name, member] : state->members) {
+        result.push_back(member);
+    }
+    return result;
+}
+
+std::unordered_map<std::string, double> RingSet::LoadDistribution(TenantID tenant) const {
+    auto guard = epoch_.Read();
+    const State* state = state_.load(std::memory_order_seq_cst);
+    const Tenant& t = GetTenant(*state, tenant);
+
+    std::unordered_map<std::string, double> result;
+    result.reserve(state->members.size());
+    for (size_t slot = 0; slot < state->member_table.size(); ++slot) {
+        if (state->member_table[slot]) {
+            result[state->names[slot]] = t.loads[slot];
+        }
+    }
+    return result;
+}
+
+} // namespace consistent
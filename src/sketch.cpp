@@ -0,0 +1,97 @@
+#include "sketch.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace consistent {
+
+namespace {
+
+// Per-row constants mixed into the hash so rows index independently
+constexpr uint64_t ROW_SEEDS[HotKeySketch::DEPTH] = {
+    0x9E3779B97F4A7C15ULL, 0xC2B2AE3D27D4EB4FULL, 0x165667B19E3779F9ULL, 0xD6E8FEB86659FD93ULL,
+};
+
+uint64_t Mix64(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBULL;
+    x ^= x >> 31;
+    return x;
+}
+
+} // namespace
+
+HotKeySketch::HotKeySketch(size_t width)
+    : width_(width), counters_(new std::atomic<uint32_t>[width * DEPTH]) {
+    if (width_ == 0) {
+        throw std::invalid_argument("sketch width must be positive");
+    }
+    for (size_t i = 0; i < width_ * DEPTH; ++i) {
+        counters_[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+size_t HotKeySketch::Index(uint64_t hash, size_t row) const {
+    return row * width_ + Mix64(hash ^ ROW_SEEDS[row]) % width_;
+}
+
+bool HotKeySketch::IsHot(uint64_t estimate, uint64_t total, double threshold) const {
+    // Until the sketch has seen a full row of events every key looks heavy
+    return total >= width_ && static_cast<double>(estimate) >= threshold * static_cast<double>(total);
+}
+
+bool HotKeySketch::Sampled(uint64_t hash) {
+    // The tick keeps a key from always falling on the same side of the sample
+    thread_local uint64_t tick = 0;
+    return (Mix64(hash + ++tick) & (SAMPLE_INTERVAL - 1)) == 0;
+}
+
+uint64_t HotKeySketch::Add(uint64_t hash, uint64_t& total) {
+    uint64_t estimate = UINT64_MAX;
+    for (size_t row = 0; row < DEPTH; ++row) {
+        uint32_t count = counters_[Index(hash, row)].fetch_add(1, std::memory_order_relaxed) + 1;
+        estimate = std::min<uint64_t>(estimate, count);
+    }
+
+    total = total_.fetch_add(1, std::memory_order_relaxed) + 1;
+    if (total == DECAY_FACTOR * width_) {
+        Decay(total);
+    }
+    return estimate;
+}
+
+bool HotKeySketch::Record(uint64_t hash, double threshold) {
+    if (!Sampled(hash)) {
+        return IsHot(hash, threshold);
+    }
+    uint64_t total;
+    uint64_t estimate = Add(hash, total);
+    return IsHot(estimate, total, threshold);
+}
+
+void HotKeySketch::Count(uint64_t hash) {
+    if (Sampled(hash)) {
+        uint64_t total;
+        Add(hash, total);
+    }
+}
+
+bool HotKeySketch::IsHot(uint64_t hash, double threshold) const {
+    uint64_t estimate = UINT64_MAX;
+    for (size_t row = 0; row < DEPTH; ++row) {
+        estimate = std::min<uint64_t>(estimate, counters_[Index(hash, row)].load(std::memory_order_relaxed));
+    }
+    return IsHot(estimate, total_.load(std::memory_order_relaxed), threshold);
+}
+
+void HotKeySketch::Decay(uint64_t total) {
+    // Only the thread that reached the window gets here; concurrent increments
+    // may land on either side of the halving, which only skews counts slightly
+    for (size_t i = 0; i < width_ * DEPTH; ++i) {
+        counters_[i].store(counters_[i].load(std::memory_order_relaxed) / 2, std::memory_order_relaxed);
+    }
+    total_.fetch_sub(total / 2, std::memory_order_relaxed);
+}
+
+} // namespace consistent
@@ -0,0 +1,359 @@
+#include "consistent.h"
+#include <cstddef>
+#include <cstring>
+#include <unordered_map>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#endif
+
+namespace consistent {
+
+namespace {
+
+// Snapshot layout, all integers in host byte order (checked via the
+// endianness marker) and every section padded to 8 bytes:
+//
+//   SnapshotHeader
+//   names      slot_count x (uint32 length, bytes), padded; empty = free slot
+//   weights    double[slot_count]
+//   loads      uint32[slot_count], padded
+//   hashes     uint64[ring_size]
+//   owners     uint32[ring_size], padded
+//   partitions uint32[partition_count], padded
+//
+// The checksum covers the header fields before it as well as the body, so a
+// damaged epoch or section size is caught before anything is decoded.
+constexpr uint32_t SNAPSHOT_MAGIC = 0x53524843; // "CHRS"
+constexpr uint32_t SNAPSHOT_ENDIAN = 0x01020304;
+
+struct SnapshotHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t endian;
+    uint32_t header_size;
+    uint64_t hasher_fingerprint;
+    uint64_t partition_count;
+    uint32_t replication_factor;
+    uint32_t slot_count;
+    double load;
+    uint64_t ring_size;
+    uint64_t epoch;
+    uint64_t names_size;
+    uint64_t body_size;
+    uint64_t checksum;
+};
+static_assert(sizeof(SnapshotHeader) % 8 == 0, "snapshot sections must stay 8-byte aligned");
+
+// CRC-64 of the header up to the checksum field and of the body, folded into one
+uint64_t ImageChecksum(const uint8_t* image, size_t body_size) {
+    uint64_t parts[2] = {
+        CRC64Hasher().Sum64(image, offsetof(SnapshotHeader, checksum)),
+        CRC64Hasher().Sum64(image + sizeof(SnapshotHeader), body_size),
+    };
+    return CRC64Hasher().Sum64(reinterpret_cast<const uint8_t*>(parts), sizeof(parts));
+}
+
+constexpr size_t Align8(size_t n) {
+    return (n + 7) & ~size_t{7};
+}
+
+// Fixed probe so images written with a different hash function, or seed, are rejected
+constexpr char FINGERPRINT_PROBE[] = "consistent-snapshot-fingerprint";
+
+class Writer {
+public:
+    explicit Writer(std::vector<uint8_t>& out) : out_(out) {}
+
+    void Bytes(const void* data, size_t size) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        out_.insert(out_.end(), bytes, bytes + size);
+    }
+
+    template <typename T>
+    void Array(const std::vector<T>& values) {
+        Bytes(values.data(), values.size() * sizeof(T));
+        Pad();
+    }
+
+    void Pad() { out_.resize(Align8(out_.size()), 0); }
+
+private:
+    std::vector<uint8_t>& out_;
+};
+
+class Reader {
+public:
+    Reader(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+    const uint8_t* Take(size_t size) {
+        if (size > size_ - pos_) {
+            throw InvalidSnapshotException("snapshot is truncated");
+        }
+        const uint8_t* at = data_ + pos_;
+        pos_ += size;
+        return at;
+    }
+
+    template <typename T>
+    std::vector<T> Array(size_t count) {
+        if (count > (size_ - pos_) / sizeof(T)) {
+            throw InvalidSnapshotException("snapshot is truncated");
+        }
+        std::vector<T> values(count);
+        const uint8_t* at = Take(count * sizeof(T));
+        if (count > 0) {
+            std::memcpy(values.data(), at, count * sizeof(T));
+        }
+        Pad();
+        return values;
+    }
+
+    void Pad() { Take(Align8(pos_) - pos_); }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+    size_t pos_ = 0;
+};
+
+} // namespace
+
+template <typename HasherT>
+uint64_t BasicConsistent<HasherT>::HasherFingerprint() const {
+    return hasher_->Sum64(std::string_view(FINGERPRINT_PROBE));
+}
+
+template <typename HasherT>
+std::vector<uint8_t> BasicConsistent<HasherT>::Serialize() const {
+    auto guard = epoch_.Read();
+    const State* state = state_.load(std::memory_order_seq_cst);
+
+    std::vector<uint8_t> out(sizeof(SnapshotHeader), 0);
+    Writer writer(out);
+
+    for (const auto& name : state->names) {
+        uint32_t length = static_cast<uint32_t>(name.size());
+        writer.Bytes(&length, sizeof(length));
+        writer.Bytes(name.data(), name.size());
+    }
+    writer.Pad();
+    size_t names_size = out.size() - sizeof(SnapshotHeader);
+
+    writer.Array(state->weights);
+    writer.Array(state->loads);
+    writer.Array(state->ring.Hashes());
+    writer.Array(state->ring.Owners());
+
+    // A ring that never had members has no partition table yet
+    std::vector<uint32_t> partitions = state->partitions;
+    partitions.resize(partition_count_, NO_OWNER);
+    writer.Array(partitions);
+
+    SnapshotHeader header{};
+    header.magic = SNAPSHOT_MAGIC;
+    header.version = SNAPSHOT_VERSION;
+    header.endian = SNAPSHOT_ENDIAN;
+    header.header_size = sizeof(SnapshotHeader);
+    header.hasher_fingerprint = HasherFingerprint();
+    header.partition_count = partition_count_;
+    header.replication_factor = static_cast<uint32_t>(config_.replication_factor);
+    header.slot_count = static_cast<uint32_t>(state->member_table.size());
+    header.load = config_.load;
+    header.ring_size = state->ring.Size();
+    header.epoch = state->epoch;
+    header.names_size = names_size;
+    header.body_size = out.size() - sizeof(SnapshotHeader);
+    std::memcpy(out.data(), &header, sizeof(header));
+    header.checksum = ImageChecksum(out.data(), header.body_size);
+    std::memcpy(out.data(), &header, sizeof(header));
+    return out;
+}
+
+template <typename HasherT>
+std::unique_ptr<BasicConsistent<HasherT>> BasicConsistent<HasherT>::LoadSnapshot(
+    const uint8_t* data, size_t size, const std::vector<std::shared_ptr<Member>>& members, Config config) {
+
+    SnapshotHeader header;
+    if (size < sizeof(header)) {
+        throw InvalidSnapshotException("snapshot is truncated");
+    }
+    std::memcpy(&header, data, sizeof(header));
+
+    if (header.magic != SNAPSHOT_MAGIC) {
+        throw InvalidSnapshotException("not a ring snapshot");
+    }
+    if (header.endian != SNAPSHOT_ENDIAN) {
+        throw InvalidSnapshotException("snapshot was written with a different byte order");
+    }
+    if (header.version != SNAPSHOT_VERSION || header.header_size != sizeof(header)) {
+        throw InvalidSnapshotException("unsupported snapshot version " + std::to_string(header.version));
+    }
+    if (header.body_size != size - sizeof(header)) {
+        throw InvalidSnapshotException("snapshot is truncated");
+    }
+
+    const uint8_t* body = data + sizeof(header);
+    if (ImageChecksum(data, header.body_size) != header.checksum) {
+        throw InvalidSnapshotException("snapshot checksum mismatch");
+    }
+
+    // Start from an empty ring, then swap in the state decoded from the image
+    std::unique_ptr<BasicConsistent> ring(new BasicConsistent({}, std::move(config)));
+
+    if (header.hasher_fingerprint != ring->HasherFingerprint()) {
+        throw InvalidSnapshotException("snapshot was written with a different hasher");
+    }
+    if (header.partition_count != ring->partition_count_ ||
+        header.replication_factor != static_cast<uint32_t>(ring->config_.replication_factor) ||
+        header.load != ring->config_.load) {
+        throw InvalidSnapshotException("snapshot was written with a different placement config");
+    }
+
+    std::unordered_map<std::string_view, std::shared_ptr<Member>> by_name;
+    for (const auto& member : members) {
+        by_name.emplace(member->Name(), member);
+    }
+
+    auto state = std::make_unique<State>();
+    state->epoch = header.epoch;
+    state->ring = Ring(static_cast<unsigned>(ring->config_.ring_index_bits));
+
+    Reader reader(body, header.body_size);
+    state->member_table.assign(header.slot_count, nullptr);
+    state->names.resize(header.slot_count);
+    state->name_hashes.assign(header.slot_count, 0);
+    for (uint32_t slot = 0; slot < header.slot_count; ++slot) {
+        uint32_t length;
+        std::memcpy(&length, reader.Take(sizeof(length)), sizeof(length));
+        if (length == 0) {
+            continue; // Free slot
+        }
+
+        std::string name(reinterpret_cast<const char*>(reader.Take(length)), length);
+        auto member = by_name.find(name);
+        if (member == by_name.end()) {
+            throw InvalidSnapshotException("snapshot member " + name + " was not provided");
+        }
+        // Two slots sharing a member would leave one behind when it is removed
+        if (!state->members.emplace(name, member->second).second) {
+            throw InvalidSnapshotException("snapshot lists member " + name + " twice");
+        }
+        state->member_table[slot] = member->second.get();
+        state->name_hashes[slot] = ring->hasher_->Sum64(name);
+        state->names[slot] = std::move(name);
+    }
+    reader.Pad();
+
+    state->weights = reader.Array<double>(header.slot_count);
+    reader.Array<uint32_t>(header.slot_count); // Loads, recounted from the partitions below
+    auto hashes = reader.Array<uint64_t>(header.ring_size);
+    auto owners = reader.Array<uint32_t>(header.ring_size);
+    state->partitions = reader.Array<uint32_t>(header.partition_count);
+
+    // Virtual node counts follow the weight, so a member re-added later must get the same ones
+    for (uint32_t slot = 0; slot < header.slot_count; ++slot) {
+        Member* member = state->member_table[slot];
+        if (member && state->weights[slot] != member->Weight()) {
+            throw InvalidSnapshotException("snapshot weight of member " + state->names[slot] +
+                                           " does not match the member");
+        }
+        if (!member) {
+            state->weights[slot] = 0;
+        }
+    }
+
+    auto live = [&](uint32_t slot) { return slot < header.slot_count && state->member_table[slot]; };
+    for (uint32_t owner : owners) {
+        if (!live(owner)) {
+            throw InvalidSnapshotException("snapshot ring refers to a free slot");
+        }
+    }
+    for (uint32_t& owner : state->partitions) {
+        if (owner != NO_OWNER && !live(owner)) {
+            throw InvalidSnapshotException("snapshot partition refers to a free slot");
+        }
+    }
+    if (!state->ring.Assign(std::move(hashes), std::move(owners))) {
+        throw InvalidSnapshotException("snapshot ring is not sorted");
+    }
+    state->loads.assign(header.slot_count, 0);
+    if (state->ring.Empty()) {
+        state->partitions.clear();
+    } else {
+        for (uint32_t owner : state->partitions) {
+            if (owner == NO_OWNER) {
+                throw InvalidSnapshotException("snapshot leaves a partition without an owner");
+            }
+            state->loads[owner]++;
+        }
+    }
+
+    ring->RefreshReplicas(*state);
+    RefreshMemberView(*state);
+    delete ring->state_.exchange(state.release(), std::memory_order_seq_cst);
+    return ring;
+}
+
+template <typename HasherT>
+std::unique_ptr<BasicConsistent<HasherT>> BasicConsistent<HasherT>::LoadSnapshotFile(
+    const std::string& path, const std::vector<std::shared_ptr<Member>>& members, Config config) {
+
+#if defined(__unix__) || defined(__APPLE__)
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw InvalidSnapshotException("cannot open snapshot " + path);
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size == 0) {
+        ::close(fd);
+        throw InvalidSnapshotException("cannot read snapshot " + path);
+    }
+
+    size_t size = static_cast<size_t>(st.st_size);
+    void* mapped = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        throw InvalidSnapshotException("cannot map snapshot " + path);
+    }
+
+    try {
+        auto ring = LoadSnapshot(static_cast<const uint8_t*>(mapped), size, members, std::move(config));
+        ::munmap(mapped, size);
+        return ring;
+    } catch (...) {
+        ::munmap(mapped, size);
+        throw;
+    }
+#else
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw InvalidSnapshotException("cannot open snapshot " + path);
+    }
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    return LoadSnapshot(data.data(), data.size(), members, std::move(config));
+#endif
+}
+
+#define CONSISTENT_INSTANTIATE_SNAPSHOT(H)                                                                   \
+    template uint64_t BasicConsistent<H>::HasherFingerprint() const;                                         \
+    template std::vector<uint8_t> BasicConsistent<H>::Serialize() const;                                    \
+    template std::unique_ptr<BasicConsistent<H>> BasicConsistent<H>::LoadSnapshot(                           \
+        const uint8_t*, size_t, const std::vector<std::shared_ptr<Member>>&, Config);                       \
+    template std::unique_ptr<BasicConsistent<H>> BasicConsistent<H>::LoadSnapshotFile(                       \
+        const std::string&, const std::vector<std::shared_ptr<Member>>&, Config);
+
+CONSISTENT_INSTANTIATE_SNAPSHOT(Hasher)
+CONSISTENT_INSTANTIATE_SNAPSHOT(CRC64Hasher)
+CONSISTENT_INSTANTIATE_SNAPSHOT(FNVHasher)
+CONSISTENT_INSTANTIATE_SNAPSHOT(XXH3Hasher)
+CONSISTENT_INSTANTIATE_SNAPSHOT(WyHasher)
+
+#undef CONSISTENT_INSTANTIATE_SNAPSHOT
+
+} // namespace consistent
@@ -0,0 +1,114 @@
+#include "stats.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace consistent {
+
+uint64_t LatencyHistogram::Count() const {
+    uint64_t count = 0;
+    for (uint64_t bucket : buckets) {
+        count += bucket;
+    }
+    return count;
+}
+
+uint64_t LatencyHistogram::Percentile(double q) const {
+    uint64_t count = Count();
+    if (count == 0) {
+        return 0;
+    }
+
+    uint64_t rank = static_cast<uint64_t>(std::ceil(std::min(std::max(q, 0.0), 1.0) * count));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < buckets.size(); ++i) {
+        seen += buckets[i];
+        if (seen >= rank && seen > 0) {
+            return uint64_t{2} << i;
+        }
+    }
+    return uint64_t{2} << (buckets.size() - 1);
+}
+
+size_t LatencyHistogram::Bucket(uint64_t ns) {
+    size_t bucket = 0;
+    while (ns > 1 && bucket + 1 < STATS_HISTOGRAM_BUCKETS) {
+        ns >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+#if CONSISTENT_ENABLE_STATS
+
+StatsCollector::StatsCollector() {
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    shard_count_ = 1;
+    while (shard_count_ < threads) {
+        shard_count_ <<= 1;
+    }
+    shard_mask_ = shard_count_ - 1;
+    shards_ = std::make_unique<Shard[]>(shard_count_);
+}
+
+StatsCollector::RebalanceTimer::RebalanceTimer(StatsCollector& stats, uint64_t wait_start)
+    : stats_(stats), start_(Now()), probes_at_start_(stats.load_probes_.load(std::memory_order_relaxed)) {
+    lock_wait_ns_ = start_ - wait_start;
+    stats_.lock_wait_ns_.fetch_add(lock_wait_ns_, std::memory_order_relaxed);
+    stats_.rebalance_in_progress_.store(true, std::memory_order_relaxed);
+}
+
+StatsCollector::RebalanceTimer::~RebalanceTimer() {
+    stats_.rebalance_in_progress_.store(false, std::memory_order_relaxed);
+}
+
+void StatsCollector::RebalanceTimer::Finish(uint64_t epoch, size_t moved, const StatsSink& sink) {
+    RebalanceEvent event;
+    event.epoch = epoch;
+    event.lock_wait_ns = lock_wait_ns_;
+    event.duration_ns = Now() - start_;
+    event.partitions_moved = moved;
+    event.load_probes = stats_.load_probes_.load(std::memory_order_relaxed) - probes_at_start_;
+
+    stats_.rebalances_.fetch_add(1, std::memory_order_relaxed);
+    stats_.rebalance_ns_.fetch_add(event.duration_ns, std::memory_order_relaxed);
+    stats_.partitions_moved_.fetch_add(moved, std::memory_order_relaxed);
+    stats_.rebalance_latency_[LatencyHistogram::Bucket(event.duration_ns)].fetch_add(1, std::memory_order_relaxed);
+
+    if (sink) {
+        sink(event);
+    }
+}
+
+size_t StatsCollector::ThreadIndex() {
+    static std::atomic<size_t> next_index{0};
+    thread_local const size_t index = next_index.fetch_add(1, std::memory_order_relaxed);
+    return index;
+}
+
+RingStats StatsCollector::Snapshot() const {
+    RingStats stats;
+    for (size_t idx = 0; idx < shard_count_; ++idx) {
+        const Shard& shard = shards_[idx];
+        stats.lookups += shard.lookups.load(std::memory_order_relaxed);
+        stats.closest_n_calls += shard.closest_n_calls.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < STATS_HISTOGRAM_BUCKETS; ++i) {
+            stats.lookup_latency.buckets[i] += shard.latency[i].load(std::memory_order_relaxed);
+        }
+    }
+
+    stats.rebalances = rebalances_.load(std::memory_order_relaxed);
+    stats.rebalance_ns = rebalance_ns_.load(std::memory_order_relaxed);
+    stats.partitions_moved = partitions_moved_.load(std::memory_order_relaxed);
+    stats.lock_wait_ns = lock_wait_ns_.load(std::memory_order_relaxed);
+    stats.load_probes = load_probes_.load(std::memory_order_relaxed);
+    stats.rebalance_in_progress = rebalance_in_progress_.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < STATS_HISTOGRAM_BUCKETS; ++i) {
+        stats.rebalance_latency.buckets[i] = rebalance_latency_[i].load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+#endif
+
+} // namespace consistent
@@ -0,0 +1,49 @@
+#include "test_util.h"
+
+#include <consistent/arena.h>
+
+#include <vector>
+
+using namespace consistent;
+
+TEST(ScratchArena, StopsAllocatingOnceGrown) {
+    ScratchArena arena(1024);
+    for (int round = 0; round < 3; ++round) {
+        arena.Reset();
+        ScratchVector<uint64_t> values(4096, 0, &arena);
+        ScratchVector<uint32_t> more(100, 0, &arena);
+    }
+    size_t capacity = arena.Capacity();
+    EXPECT_GE(capacity, 4096 * sizeof(uint64_t));
+
+    arena.Reset();
+    ScratchVector<uint64_t> values(4096, 0, &arena);
+    arena.Reset();
+    EXPECT_EQ(arena.Capacity(), capacity);
+}
+
+// A change that publishes nothing, or fails, parks its state without keeping
+// references to the members it copied
+TEST(SpareState, HoldsNoMembers) {
+    auto members = MakeMembers(0, 10);
+    std::vector<std::uint8_t> delta;
+    Config config(CreateCRC64Hasher());
+    config.on_ring_delta = [&](uint64_t, const std::vector<uint8_t>& encoded) { delta = encoded; };
+    Consistent c(members, std::move(config));
+    c.Add(MakeMember(20));
+    long published = members[0].use_count();
+
+    EXPECT_TRUE(c.Add(members[0]).empty());
+    EXPECT_EQ(members[0].use_count(), published);
+    EXPECT_TRUE(c.RemoveByName("missing").empty());
+    EXPECT_EQ(members[0].use_count(), published);
+    EXPECT_TRUE(c.RebalanceByLoad().empty());
+    EXPECT_EQ(members[0].use_count(), published);
+
+    // A delta that fails halfway through replay
+    Consistent follower(members, Config(CreateCRC64Hasher()));
+    EXPECT_THROW(follower.ApplyDelta(delta.data(), delta.size(), members), InvalidDeltaException);
+    long follower_refs = members[0].use_count();
+    EXPECT_THROW(follower.ApplyDelta(delta.data(), delta.size(), members), InvalidDeltaException);
+    EXPECT_EQ(members[0].use_count(), follower_refs);
+}
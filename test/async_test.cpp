@@ -0,0 +1,38 @@
+#include "test_util.h"
+
+#include <future>
+#include <memory>
+#include <vector>
+
+using namespace consistent;
+
+TEST(Async, MatchesChangesAppliedInOrder) {
+    auto members = MakeMembers(0, 10);
+    Consistent async_ring(members, Config(CreateCRC64Hasher()));
+    Consistent sync_ring(members, Config(CreateCRC64Hasher()));
+
+    std::vector<std::future<std::vector<PartitionMove>>> pending;
+    pending.push_back(async_ring.AddAsync(MakeMember(20)));
+    pending.push_back(async_ring.RemoveAsync(members[1]->Name()));
+    pending.push_back(async_ring.AddAsync(MakeMember(21)));
+    pending.push_back(async_ring.RemoveAsync(MakeMember(20)->Name()));
+    pending.push_back(async_ring.AddAsync(MakeMember(20)));
+    for (auto& result : pending) {
+        result.get();
+    }
+
+    sync_ring.Add(MakeMember(20));
+    sync_ring.RemoveByName(members[1]->Name());
+    sync_ring.Add(MakeMember(21));
+    sync_ring.RemoveByName(MakeMember(20)->Name());
+    sync_ring.Add(MakeMember(20));
+
+    ExpectSamePlacement(async_ring, sync_ring);
+}
+
+TEST(Async, ReportsErrorsThroughTheFuture) {
+    Consistent c(MakeMembers(0, 10), Config(CreateCRC64Hasher()));
+    auto invalid = std::make_shared<GatewayMember>("bad", "10.0.0.99", 9000, -1.0);
+    EXPECT_THROW(c.AddAsync(invalid).get(), std::invalid_argument);
+    EXPECT_EQ(c.GetMembers().size(), 10u);
+}
@@ -0,0 +1,63 @@
+#include "test_util.h"
+
+#include <vector>
+
+using namespace consistent;
+
+TEST(Delta, FollowerTracksCoordinator) {
+    auto all = MakeMembers(0, 30);
+    std::vector<std::vector<uint8_t>> deltas;
+    Config leader_config(CreateCRC64Hasher());
+    leader_config.on_ring_delta = [&](uint64_t, const std::vector<uint8_t>& delta) { deltas.push_back(delta); };
+    Consistent leader({}, std::move(leader_config));
+    Consistent follower({}, Config(CreateCRC64Hasher()));
+
+    auto replicate = [&](const std::vector<PartitionMove>& moves) {
+        std::vector<PartitionMove> applied = follower.ApplyDelta(deltas.back().data(), deltas.back().size(), all);
+        ASSERT_EQ(applied.size(), moves.size());
+        for (size_t i = 0; i < moves.size(); ++i) {
+            EXPECT_EQ(applied[i].part_id, moves[i].part_id);
+        }
+        ExpectSamePlacement(leader, follower);
+        EXPECT_EQ(leader.Serialize(), follower.Serialize());
+    };
+
+    replicate(leader.AddMany({all[0], all[1], all[2], all[3], all[4], all[5], all[6], all[7], all[8], all[9]}));
+    replicate(leader.Add(all[10]));
+    replicate(leader.RemoveByName(all[2]->Name()));
+    replicate(leader.ApplyChanges({all[11], all[12]}, {all[0]->Name(), all[5]->Name()}));
+
+    // A no-op change publishes nothing
+    size_t published = deltas.size();
+    EXPECT_TRUE(leader.Add(all[12]).empty());
+    EXPECT_EQ(deltas.size(), published);
+}
+
+TEST(Delta, RejectsStaleAndDamagedDeltas) {
+    auto all = MakeMembers(0, 30);
+    std::vector<std::vector<uint8_t>> deltas;
+    Config leader_config(CreateCRC64Hasher());
+    leader_config.on_ring_delta = [&](uint64_t, const std::vector<uint8_t>& delta) { deltas.push_back(delta); };
+    Consistent leader({}, std::move(leader_config));
+    Consistent follower({}, Config(CreateCRC64Hasher()));
+
+    leader.AddMany(MakeMembers(0, 10));
+    follower.ApplyDelta(deltas.back().data(), deltas.back().size(), all);
+    leader.Add(all[15]);
+
+    // Replaying an applied delta, or skipping one, is stale
+    EXPECT_THROW(follower.ApplyDelta(deltas[0].data(), deltas[0].size(), all), StaleRingException);
+    leader.Add(all[16]);
+    EXPECT_THROW(follower.ApplyDelta(deltas[2].data(), deltas[2].size(), all), StaleRingException);
+
+    std::vector<uint8_t> damaged = deltas[1];
+    damaged[damaged.size() / 2] ^= 0x40;
+    EXPECT_THROW(follower.ApplyDelta(damaged.data(), damaged.size(), all), InvalidDeltaException);
+    EXPECT_THROW(follower.ApplyDelta(deltas[1].data(), deltas[1].size(), {all[1]}), InvalidDeltaException);
+
+    // Failed deltas leave the follower where it was
+    EXPECT_EQ(follower.Epoch() + 2, leader.Epoch());
+    follower.ApplyDelta(deltas[1].data(), deltas[1].size(), all);
+    follower.ApplyDelta(deltas[2].data(), deltas[2].size(), all);
+    ExpectSamePlacement(leader, follower);
+}
@@ -0,0 +1,87 @@
+#include "test_util.h"
+
+#include <consistent/pool.h>
+#include <consistent/ringset.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+using namespace consistent;
+
+namespace {
+
+std::vector<std::shared_ptr<Member>> WeightedMembers(int count) {
+    std::vector<std::shared_ptr<Member>> members;
+    for (int i = 0; i < count; ++i) {
+        members.push_back(MakeMember(i, 0.5 + (i % 4) * 0.5));
+    }
+    return members;
+}
+
+Config DistributionConfig(int threads) {
+    Config config(CreateXXH3Hasher(), 65536, 50);
+    config.distribution_threads = threads;
+    return config;
+}
+
+} // namespace
+
+TEST(WorkerPool, CoversEveryIndexOnce) {
+    for (int threads : {1, 3, 8}) {
+        WorkerPool pool(threads);
+        EXPECT_EQ(pool.Threads(), threads);
+        for (uint64_t count : {uint64_t{0}, uint64_t{1}, uint64_t{7}, uint64_t{10000}}) {
+            std::vector<std::atomic<int>> hits(count);
+            for (int round = 0; round < 3; ++round) {
+                pool.Run(count, [&](uint64_t begin, uint64_t end) {
+                    for (uint64_t i = begin; i < end; ++i) {
+                        hits[i]++;
+                    }
+                });
+            }
+            for (const auto& hit : hits) {
+                ASSERT_EQ(hit.load(), 3);
+            }
+        }
+    }
+    EXPECT_GE(WorkerPool(0).Threads(), 1);
+}
+
+TEST(WorkerPool, RethrowsFromWorkers) {
+    WorkerPool pool(4);
+    EXPECT_THROW(pool.Run(100, [](uint64_t begin, uint64_t) {
+        if (begin > 0) {
+            throw std::runtime_error("chunk failed");
+        }
+    }), std::runtime_error);
+
+    // The pool keeps working afterwards
+    std::atomic<uint64_t> total{0};
+    pool.Run(100, [&](uint64_t begin, uint64_t end) { total += end - begin; });
+    EXPECT_EQ(total.load(), 100u);
+}
+
+// The threads only split the partition sweeps, so the owners never depend on them
+TEST(Distribution, ParallelMatchesSerial) {
+    auto members = WeightedMembers(1000);
+    Consistent serial(members, DistributionConfig(1));
+    Consistent parallel(members, DistributionConfig(4));
+    EXPECT_EQ(serial.Serialize(), parallel.Serialize());
+    ExpectSamePlacement(serial, parallel);
+
+    for (Consistent* c : {&serial, &parallel}) {
+        c->Add(MakeMember(2000, 2.0));
+        c->RemoveByName(members[10]->Name());
+    }
+    EXPECT_EQ(serial.Serialize(), parallel.Serialize());
+
+    RingSet serial_set(members, CreateXXH3Hasher(), 50, 1);
+    RingSet parallel_set(members, CreateXXH3Hasher(), 50, 4);
+    TenantID serial_tenant = serial_set.AddTenant(65536);
+    TenantID parallel_tenant = parallel_set.AddTenant(65536);
+    EXPECT_EQ(serial_set.LoadDistribution(serial_tenant), parallel_set.LoadDistribution(parallel_tenant));
+    for (const auto& key : ProbeKeys()) {
+        ASSERT_EQ(serial_set.LocateKey(serial_tenant, key), parallel_set.LocateKey(parallel_tenant, key));
+    }
+}
@@ -0,0 +1,149 @@
+#include "test_util.h"
+
+#include <consistent/jump.h>
+#include <consistent/maglev.h>
+
+#include <cmath>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace consistent;
+
+namespace {
+
+template <typename Engine>
+std::vector<std::string> KeyOwners(const Engine& engine, const std::vector<std::string>& keys) {
+    std::vector<std::string> owners;
+    for (const auto& key : keys) {
+        owners.push_back(engine.LocateKey(key)->Name());
+    }
+    return owners;
+}
+
+// GetClosestN starts at the LocateKey owner and lists distinct members
+template <typename Engine>
+void ExpectClosestNConsistent(const Engine& engine, int count) {
+    std::vector<Member*> raw(count);
+    for (int i = 0; i < 500; ++i) {
+        std::string key = "closest" + std::to_string(i);
+        auto closest = engine.GetClosestN(key, count);
+        ASSERT_EQ(closest.size(), static_cast<size_t>(count));
+        EXPECT_EQ(closest[0], engine.LocateKey(key));
+        std::set<std::string> names;
+        for (const auto& member : closest) {
+            names.insert(member->Name());
+        }
+        EXPECT_EQ(names.size(), closest.size());
+
+        ASSERT_EQ(engine.GetClosestN(std::string_view(key), count, raw.data()), count);
+        for (int j = 0; j < count; ++j) {
+            EXPECT_EQ(raw[j], closest[j].get());
+        }
+    }
+    EXPECT_THROW(engine.GetClosestN("key", static_cast<int>(engine.GetMembers().size()) + 1),
+                 InsufficientMemberCountException);
+}
+
+} // namespace
+
+TEST(Jump, Deterministic) {
+    // Each key either keeps its bucket or moves to the new one as buckets grow
+    for (uint64_t key = 1; key < 5000; ++key) {
+        uint64_t hkey = key * 0x9E3779B97F4A7C15ULL;
+        EXPECT_EQ(JumpConsistent::JumpHash(hkey, 1), 0);
+        for (int32_t buckets = 1; buckets < 40; ++buckets) {
+            int32_t bucket = JumpConsistent::JumpHash(hkey, buckets);
+            int32_t grown = JumpConsistent::JumpHash(hkey, buckets + 1);
+            ASSERT_TRUE(grown == bucket || grown == buckets) << key << " " << buckets;
+        }
+    }
+
+    // The same member list places keys the same however it was built
+    auto members = MakeMembers(0, 10);
+    JumpConsistent built(members, CreateXXH3Hasher());
+    JumpConsistent grown({}, CreateXXH3Hasher());
+    for (const auto& member : members) {
+        grown.Add(member);
+    }
+    grown.Add(MakeMember(30));
+    grown.RemoveByName(MakeMember(30)->Name());
+    EXPECT_EQ(KeyOwners(built, ProbeKeys()), KeyOwners(grown, ProbeKeys()));
+    ExpectClosestNConsistent(built, 3);
+}
+
+TEST(Jump, MinimalMovement) {
+    auto members = MakeMembers(0, 10);
+    JumpConsistent c(members, CreateXXH3Hasher());
+    std::vector<std::string> keys = ProbeKeys();
+    std::vector<std::string> before = KeyOwners(c, keys);
+
+    // Keys only move to the new member, about 1/11 of them
+    auto added = MakeMember(10);
+    std::vector<PartitionMove> moves = c.Add(added);
+    ASSERT_EQ(moves.size(), 1u);
+    EXPECT_EQ(moves[0].part_id, 10);
+    EXPECT_EQ(moves[0].from, nullptr);
+    EXPECT_EQ(moves[0].to, added);
+
+    std::vector<std::string> after = KeyOwners(c, keys);
+    size_t moved = 0;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        if (after[i] != before[i]) {
+            EXPECT_EQ(after[i], added->Name());
+            moved++;
+        }
+    }
+    double expected = keys.size() / 11.0;
+    EXPECT_LT(std::abs(moved - expected), expected * 0.1);
+
+    // Removing the last member hands exactly its keys back
+    EXPECT_TRUE(c.RemoveByName("missing").empty());
+    moves = c.RemoveByName(added->Name());
+    ASSERT_EQ(moves.size(), 1u);
+    EXPECT_EQ(moves[0].to, nullptr);
+    EXPECT_EQ(KeyOwners(c, keys), before);
+
+    // Removing another member renumbers the shards after it
+    moves = c.RemoveByName(members[7]->Name());
+    ASSERT_EQ(moves.size(), 3u);
+    EXPECT_EQ(moves[0].part_id, 7);
+    EXPECT_EQ(moves[0].to, members[8]);
+    EXPECT_EQ(moves[2].to, nullptr);
+}
+
+TEST(Maglev, TableBalance) {
+    auto members = MakeMembers(0, 7);
+    MaglevConsistent c(members, CreateXXH3Hasher());
+
+    auto expect_balanced = [&](size_t member_count) {
+        auto loads = c.LoadDistribution();
+        ASSERT_EQ(loads.size(), member_count);
+        double total = 0;
+        for (const auto& [name, entries] : loads) {
+            EXPECT_GE(entries, std::floor(double(DEFAULT_MAGLEV_TABLE_SIZE) / member_count)) << name;
+            EXPECT_LE(entries, std::ceil(double(DEFAULT_MAGLEV_TABLE_SIZE) / member_count)) << name;
+            total += entries;
+        }
+        EXPECT_EQ(total, DEFAULT_MAGLEV_TABLE_SIZE);
+    };
+    expect_balanced(7);
+    ExpectClosestNConsistent(c, 3);
+
+    // The new member's entries all show up as moves
+    auto added = MakeMember(20);
+    std::vector<PartitionMove> moves = c.Add(added);
+    expect_balanced(8);
+    size_t to_added = 0;
+    for (const auto& move : moves) {
+        EXPECT_NE(move.from, move.to);
+        to_added += move.to == added;
+    }
+    EXPECT_EQ(to_added, c.LoadDistribution().at(added->Name()));
+
+    EXPECT_TRUE(c.RemoveByName("missing").empty());
+    moves = c.RemoveByName(members[2]->Name());
+    expect_balanced(7);
+    EXPECT_GE(moves.size(), DEFAULT_MAGLEV_TABLE_SIZE / 8);
+    ExpectClosestNConsistent(c, 7);
+}
@@ -0,0 +1,135 @@
+#include <consistent/hasher.h>
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace consistent;
+
+namespace {
+
+// Inputs for the golden digests: lengths 0..300 cover every size class of
+// the hashers, 4096 runs several XXH3 blocks
+std::vector<uint8_t> GoldenInput() {
+    std::vector<uint8_t> input(4096);
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    for (auto& byte : input) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        byte = static_cast<uint8_t>(state);
+    }
+    return input;
+}
+
+std::vector<size_t> GoldenLengths() {
+    std::vector<size_t> lengths;
+    for (size_t length = 0; length <= 300; ++length) {
+        lengths.push_back(length);
+    }
+    lengths.push_back(4096);
+    return lengths;
+}
+
+// FNV-1a style fold of the hash of every golden length, so one constant pins them all
+uint64_t GoldenDigest(const Hasher& hasher) {
+    std::vector<uint8_t> input = GoldenInput();
+    uint64_t digest = 0xcbf29ce484222325ULL;
+    for (size_t length : GoldenLengths()) {
+        digest = (digest ^ hasher.Sum64(input.data(), length)) * 0x100000001b3ULL;
+    }
+    return digest;
+}
+
+// Every golden length hashes the same from any alignment and through every overload
+void ExpectAlignmentIndependent(const Hasher& hasher) {
+    std::vector<uint8_t> input = GoldenInput();
+    std::vector<uint8_t> shifted(input.size() + 16);
+    for (size_t offset = 1; offset < 16; offset += 2) {
+        std::memcpy(shifted.data() + offset, input.data(), input.size());
+        for (size_t length : GoldenLengths()) {
+            uint64_t expected = hasher.Sum64(input.data(), length);
+            ASSERT_EQ(hasher.Sum64(shifted.data() + offset, length), expected)
+                << "offset " << offset << " length " << length;
+            ASSERT_EQ(hasher.Sum64(std::vector<uint8_t>(input.begin(), input.begin() + length)), expected);
+            ASSERT_EQ(hasher.Sum64(std::string(input.begin(), input.begin() + length)), expected);
+        }
+    }
+}
+
+uint64_t Sum(const Hasher& hasher, const char* text) {
+    return hasher.Sum64(reinterpret_cast<const uint8_t*>(text), std::strlen(text));
+}
+
+} // namespace
+
+// Digests recorded with the baseline byte-at-a-time implementations
+TEST(CRC64Hasher, MatchesBaseline) {
+    CRC64Hasher hasher;
+    EXPECT_EQ(Sum(hasher, "123456789"), 0xb90956c775a41001ULL); // CRC-64/GO-ISO check value
+    EXPECT_EQ(GoldenDigest(hasher), 0xec7a826d81076f9bULL);
+    ExpectAlignmentIndependent(hasher);
+}
+
+TEST(CRC64Hasher, TablePathMatchesFastPath) {
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+    // A CPU with carry-less multiply must not silently fall back to the tables
+    if (__builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1")) {
+        EXPECT_TRUE(CRC64Hasher::Accelerated());
+    }
+#endif
+    CRC64Hasher hasher;
+    std::vector<uint8_t> input = GoldenInput();
+    std::vector<uint8_t> shifted(input.size() + 16);
+    for (size_t offset = 0; offset < 16; offset += 3) {
+        std::memcpy(shifted.data() + offset, input.data(), input.size());
+        for (size_t length : GoldenLengths()) {
+            ASSERT_EQ(CRC64Hasher::Sum64Table(shifted.data() + offset, length),
+                      hasher.Sum64(shifted.data() + offset, length))
+                << "offset " << offset << " length " << length;
+        }
+    }
+}
+
+TEST(FNVHasher, MatchesBaseline) {
+    FNVHasher hasher;
+    EXPECT_EQ(Sum(hasher, "123456789"), 0x06d5573923c6cdfcULL);
+    EXPECT_EQ(GoldenDigest(hasher), 0x430cee51027e3638ULL);
+    ExpectAlignmentIndependent(hasher);
+}
+
+// Vectors and digests from the reference xxHash 0.8 XXH3_64bits / XXH3_64bits_withSeed
+TEST(XXH3Hasher, MatchesReference) {
+    XXH3Hasher hasher;
+    EXPECT_EQ(Sum(hasher, ""), 0x2d06800538d394c2ULL);
+    EXPECT_EQ(Sum(hasher, "a"), 0xe6c632b61e964e1fULL);
+    EXPECT_EQ(Sum(hasher, "abc"), 0x78af5f94892f3950ULL);
+    EXPECT_EQ(Sum(hasher, "message digest"), 0x160d8e9329be94f9ULL);
+    EXPECT_EQ(Sum(hasher, "abcdefghijklmnopqrstuvwxyz"), 0x810f9ca067fbb90cULL);
+    EXPECT_EQ(Sum(hasher, "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789"), 0x643542bb51639cb2ULL);
+    EXPECT_EQ(Sum(XXH3Hasher(0x9E3779B185EBCA87ULL), "abc"), 0x7dea5da88765fa10ULL);
+
+    EXPECT_EQ(GoldenDigest(hasher), 0x870cf4a2bce018e4ULL);
+    EXPECT_EQ(GoldenDigest(XXH3Hasher(0x9E3779B185EBCA87ULL)), 0xb6d40c8131e712d1ULL);
+    ExpectAlignmentIndependent(hasher);
+    ExpectAlignmentIndependent(XXH3Hasher(0x9E3779B185EBCA87ULL));
+}
+
+// Vectors from the wyhash final4 test_vector.cpp, each hashed with its index as seed
+TEST(WyHasher, MatchesReference) {
+    EXPECT_EQ(Sum(WyHasher(0), ""), 0x93228a4de0eec5a2ULL);
+    EXPECT_EQ(Sum(WyHasher(1), "a"), 0xc5bac3db178713c4ULL);
+    EXPECT_EQ(Sum(WyHasher(2), "abc"), 0xa97f2f7b1d9b3314ULL);
+    EXPECT_EQ(Sum(WyHasher(3), "message digest"), 0x786d1f1df3801df4ULL);
+    EXPECT_EQ(Sum(WyHasher(4), "abcdefghijklmnopqrstuvwxyz"), 0xdca5a8138ad37c87ULL);
+    EXPECT_EQ(Sum(WyHasher(5), "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789"),
+              0xb9e734f117cfaf70ULL);
+    const char* digits = "12345678901234567890123456789012345678901234567890123456789012345678901234567890";
+    EXPECT_EQ(Sum(WyHasher(6), digits), 0x6cc5eab49a92d617ULL);
+
+    EXPECT_EQ(GoldenDigest(WyHasher()), 0x20ae6f4217a9d660ULL);
+    EXPECT_EQ(GoldenDigest(WyHasher(0x9E3779B185EBCA87ULL)), 0xd5e8cc72abcc9c3bULL);
+    ExpectAlignmentIndependent(WyHasher());
+}
@@ -0,0 +1,59 @@
+#include "test_util.h"
+
+#include <map>
+#include <set>
+#include <string>
+
+using namespace consistent;
+
+namespace {
+
+Config HotKeyConfig() {
+    Config config(CreateXXH3Hasher());
+    config.hot_key_sketch_width = 1024;
+    config.hot_key_threshold = 0.05;
+    config.hot_key_replicas = 3;
+    return config;
+}
+
+} // namespace
+
+TEST(HotKeys, SpreadAcrossReplicas) {
+    Consistent c(MakeMembers(0, 12), HotKeyConfig());
+
+    // One key in four is "hot"; the rest are all distinct
+    for (int i = 0; i < 40000; ++i) {
+        c.LocateKeySpread(i % 4 == 0 ? std::string("hot") : "cold" + std::to_string(i));
+    }
+    ASSERT_TRUE(c.IsHotKey("hot"));
+    EXPECT_FALSE(c.IsHotKey("cold1"));
+
+    // A hot key goes to each of its first hot_key_replicas members, about evenly
+    std::map<std::string, int> owners;
+    for (int i = 0; i < 3000; ++i) {
+        owners[c.LocateKeySpread("hot")->Name()]++;
+    }
+    std::set<std::string> closest;
+    for (const auto& member : c.GetClosestN("hot", 3)) {
+        closest.insert(member->Name());
+    }
+    ASSERT_EQ(owners.size(), 3u);
+    for (const auto& [name, count] : owners) {
+        EXPECT_TRUE(closest.count(name)) << name;
+        EXPECT_GT(count, 3000 / 3 / 2) << name;
+    }
+
+    // Cold keys keep going to their owner
+    for (int i = 0; i < 200; ++i) {
+        std::string key = "cold" + std::to_string(i);
+        EXPECT_EQ(c.LocateKeySpread(key), c.LocateKey(key));
+    }
+}
+
+TEST(HotKeys, SpreadDisabledWithoutSketch) {
+    Consistent c(MakeMembers(0, 12), Config(CreateXXH3Hasher()));
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_EQ(c.LocateKeySpread("hot"), c.LocateKey("hot"));
+    }
+    EXPECT_FALSE(c.IsHotKey("hot"));
+}
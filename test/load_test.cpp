@@ -0,0 +1,46 @@
+#include "test_util.h"
+
+#include <consistent/ringset.h>
+
+#include <string>
+#include <unordered_map>
+
+using namespace consistent;
+
+namespace {
+
+// Every member is listed, members without partitions with 0, and the loads
+// add up to the partition count
+void ExpectEveryMemberListed(const std::unordered_map<std::string, double>& loads,
+                             const std::vector<std::shared_ptr<Member>>& members, int partition_count) {
+    ASSERT_EQ(loads.size(), members.size());
+    double total = 0;
+    size_t idle = 0;
+    for (const auto& member : members) {
+        ASSERT_TRUE(loads.count(member->Name())) << member->Name();
+        total += loads.at(member->Name());
+        idle += loads.at(member->Name()) == 0;
+    }
+    EXPECT_EQ(total, partition_count);
+    EXPECT_GT(idle, 0u);
+}
+
+} // namespace
+
+// Fewer partitions than members leaves some members without any
+TEST(LoadDistribution, ListsMembersWithoutPartitions) {
+    std::vector<std::shared_ptr<Member>> members;
+    for (int i = 0; i < 12; ++i) {
+        members.push_back(MakeMember(i));
+    }
+    Consistent c(members, Config(CreateCRC64Hasher(), 10));
+    ExpectEveryMemberListed(c.LoadDistribution(), members, 10);
+    EXPECT_EQ(c.GetMemberView()->loads, c.LoadDistribution());
+
+    c.Add(MakeMember(20));
+    members.push_back(MakeMember(20));
+    ExpectEveryMemberListed(c.LoadDistribution(), members, 10);
+
+    RingSet set(members, CreateCRC64Hasher());
+    ExpectEveryMemberListed(set.LoadDistribution(set.AddTenant(10, 1.5)), members, 10);
+}
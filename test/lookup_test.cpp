@@ -0,0 +1,69 @@
+#include "test_util.h"
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace consistent;
+
+namespace {
+
+// Keys of many lengths, not a multiple of the batch size
+std::vector<std::string> BatchKeys() {
+    std::vector<std::string> keys;
+    for (int i = 0; i < 1003; ++i) {
+        keys.push_back(std::string(i % 40, 'k') + std::to_string(i));
+    }
+    return keys;
+}
+
+void ExpectBatchMatchesSingle(const Consistent& c) {
+    std::vector<std::string> keys = BatchKeys();
+    std::vector<std::string_view> views(keys.begin(), keys.end());
+
+    std::vector<Member*> owners, view_owners;
+    std::vector<int> parts, view_parts;
+    c.LocateKeys(keys, owners);
+    c.LocateKeys(views, view_owners);
+    c.LocatePartitionIDs(keys, parts);
+    c.LocatePartitionIDs(views, view_parts);
+
+    ASSERT_EQ(owners.size(), keys.size());
+    EXPECT_EQ(owners, view_owners);
+    EXPECT_EQ(parts, view_parts);
+    for (size_t i = 0; i < keys.size(); ++i) {
+        ASSERT_EQ(owners[i], c.LocateKey(keys[i]).get()) << keys[i];
+    }
+}
+
+} // namespace
+
+TEST(LocateKeys, MatchesLocateKey) {
+    std::vector<std::function<std::unique_ptr<Hasher>()>> hashers = {
+        [] { return CreateCRC64Hasher(); },
+        [] { return CreateFNVHasher(); },
+        [] { return CreateXXH3Hasher(); },
+        [] { return CreateWyHasher(); },
+    };
+    for (const auto& make : hashers) {
+        Consistent c(MakeMembers(0, 12), Config(make()));
+        ExpectBatchMatchesSingle(c);
+
+        Config ring_config(make());
+        ring_config.lookup_mode = LookupMode::Ring;
+        Consistent ring(MakeMembers(0, 12), std::move(ring_config));
+        ExpectBatchMatchesSingle(ring);
+    }
+}
+
+TEST(LocateKeys, EmptyRing) {
+    Consistent c({}, Config(CreateCRC64Hasher()));
+    std::vector<Member*> owners = {nullptr};
+    c.LocateKeys(BatchKeys(), owners);
+    ASSERT_EQ(owners.size(), BatchKeys().size());
+    for (Member* owner : owners) {
+        EXPECT_EQ(owner, nullptr);
+    }
+}
@@ -0,0 +1,67 @@
+#include "test_util.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace consistent;
+
+namespace {
+
+std::vector<std::string> SortedNames(const std::vector<std::shared_ptr<Member>>& members) {
+    std::vector<std::string> names;
+    for (const auto& member : members) {
+        names.push_back(member->Name());
+    }
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+void ExpectViewMatchesRing(const Consistent& c) {
+    auto view = c.GetMemberView();
+    EXPECT_EQ(view->epoch, c.Epoch());
+    EXPECT_EQ(SortedNames(view->members), SortedNames(c.GetMembers()));
+    EXPECT_EQ(view->loads, c.LoadDistribution());
+}
+
+} // namespace
+
+TEST(MemberView, SharedUntilNextChange) {
+    Consistent c(MakeMembers(0, 10), Config(CreateCRC64Hasher()));
+    auto view = c.GetMemberView();
+    EXPECT_EQ(c.GetMemberView(), view);
+    ExpectViewMatchesRing(c);
+
+    // Changes that publish nothing keep the view
+    c.Add(MakeMember(0));
+    c.RemoveByName("missing");
+    EXPECT_EQ(c.GetMemberView(), view);
+
+    c.Add(MakeMember(20));
+    auto added = c.GetMemberView();
+    EXPECT_NE(added, view);
+    EXPECT_EQ(added->epoch, view->epoch + 1);
+    ExpectViewMatchesRing(c);
+
+    c.RemoveByName(MakeMember(3)->Name());
+    EXPECT_EQ(c.GetMemberView()->epoch, added->epoch + 1);
+    ExpectViewMatchesRing(c);
+
+    // Views already handed out keep describing their own epoch
+    EXPECT_EQ(SortedNames(view->members), SortedNames(MakeMembers(0, 10)));
+    EXPECT_EQ(view->loads.size(), 10u);
+    EXPECT_EQ(view->loads.count(MakeMember(20)->Name()), 0u);
+    EXPECT_EQ(added->members.size(), 11u);
+    EXPECT_EQ(added->loads.count(MakeMember(3)->Name()), 1u);
+}
+
+TEST(MemberView, EmptyRing) {
+    Consistent c({}, Config(CreateCRC64Hasher()));
+    auto view = c.GetMemberView();
+    EXPECT_TRUE(view->members.empty());
+    EXPECT_TRUE(view->loads.empty());
+    c.Add(MakeMember(1));
+    ExpectViewMatchesRing(c);
+    EXPECT_TRUE(view->members.empty());
+}
@@ -0,0 +1,78 @@
+#include "test_util.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace consistent;
+
+TEST(Moves, MatchOwnerDiff) {
+    for (bool incremental : {false, true}) {
+        Config config(CreateCRC64Hasher());
+        config.incremental_rebalance = incremental;
+        std::vector<PartitionMove> reported;
+        config.on_partition_moves = [&](const std::vector<PartitionMove>& moves) { reported = moves; };
+        Consistent c(MakeMembers(0, 12), std::move(config));
+
+        auto check = [&](const std::map<int, std::string>& before, const std::vector<PartitionMove>& moves) {
+            std::map<int, std::string> after = PartitionOwners(c);
+            std::map<int, std::string> changed;
+            for (const auto& [part_id, owner] : after) {
+                if (before.at(part_id) != owner) {
+                    changed[part_id] = owner;
+                }
+            }
+
+            ASSERT_EQ(moves.size(), changed.size());
+            int previous = -1;
+            for (const auto& move : moves) {
+                EXPECT_GT(move.part_id, previous);
+                previous = move.part_id;
+                ASSERT_TRUE(changed.count(move.part_id));
+                EXPECT_EQ(move.from ? move.from->Name() : "", before.at(move.part_id));
+                EXPECT_EQ(move.to ? move.to->Name() : "", changed[move.part_id]);
+            }
+            EXPECT_EQ(reported.size(), moves.size());
+        };
+
+        auto before = PartitionOwners(c);
+        check(before, c.Add(MakeMember(30, 2.0)));
+        before = PartitionOwners(c);
+        check(before, c.RemoveByName(MakeMember(4)->Name()));
+        before = PartitionOwners(c);
+        check(before, c.ApplyChanges({MakeMember(31), MakeMember(32)}, {MakeMember(0)->Name(), MakeMember(7)->Name()}));
+    }
+}
+
+// Deltas carry the recorded moves, including partitions that stay on a slot
+// whose member was replaced in the same change
+TEST(Moves, DeltaCarriesRecordedMoves) {
+    for (bool incremental : {false, true}) {
+        auto all = MakeMembers(0, 20);
+        std::vector<uint8_t> delta;
+        Config leader_config(CreateCRC64Hasher());
+        leader_config.incremental_rebalance = incremental;
+        leader_config.on_ring_delta = [&](uint64_t, const std::vector<uint8_t>& encoded) { delta = encoded; };
+        Consistent leader({}, std::move(leader_config));
+        Consistent follower({}, Config(CreateCRC64Hasher()));
+
+        auto replicate = [&](const std::vector<PartitionMove>& moves) {
+            std::vector<PartitionMove> applied = follower.ApplyDelta(delta.data(), delta.size(), all);
+            ASSERT_EQ(applied.size(), moves.size());
+            for (size_t i = 0; i < moves.size(); ++i) {
+                EXPECT_EQ(applied[i].part_id, moves[i].part_id);
+                EXPECT_EQ(applied[i].to, moves[i].to);
+            }
+            if (!leader.GetMembers().empty()) {
+                ExpectSamePlacement(leader, follower);
+            }
+            EXPECT_EQ(leader.Serialize(), follower.Serialize());
+        };
+
+        replicate(leader.AddMany({all[0], all[1], all[2], all[3], all[4], all[5], all[6], all[7]}));
+        replicate(leader.ApplyChanges({all[12]}, {all[3]->Name()}));
+        replicate(leader.ApplyChanges({all[4]}, {all[4]->Name()}));
+        replicate(leader.ApplyChanges({}, {all[0]->Name(), all[1]->Name(), all[2]->Name(), all[4]->Name(),
+                                          all[5]->Name(), all[6]->Name(), all[7]->Name(), all[12]->Name()}));
+    }
+}
@@ -0,0 +1,49 @@
+#include "test_util.h"
+
+#include <string>
+#include <vector>
+
+using namespace consistent;
+
+namespace {
+
+// Counts up to the table and past it, where lookups fall back to the ring walk
+void ExpectSameClosestN(const Consistent& precomputed, const Consistent& walked) {
+    std::vector<Member*> x(6), y(6);
+    for (int i = 0; i < 2000; ++i) {
+        std::string key = "replica" + std::to_string(i);
+        for (int count = 1; count <= 5; ++count) {
+            int written = precomputed.GetClosestN(key, count, x.data());
+            ASSERT_EQ(written, walked.GetClosestN(key, count, y.data()));
+            for (int j = 0; j < written; ++j) {
+                ASSERT_EQ(x[j]->Name(), y[j]->Name()) << key << " count " << count;
+            }
+        }
+    }
+}
+
+} // namespace
+
+TEST(PrecomputedReplicas, MatchRingWalk) {
+    for (bool incremental : {false, true}) {
+        Config precomputed_config(CreateCRC64Hasher());
+        precomputed_config.precompute_replicas = 3;
+        precomputed_config.incremental_rebalance = incremental;
+        Config walked_config(CreateCRC64Hasher());
+        walked_config.incremental_rebalance = incremental;
+
+        auto members = MakeMembers(0, 10);
+        Consistent precomputed(members, std::move(precomputed_config));
+        Consistent walked(members, std::move(walked_config));
+        ExpectSamePlacement(precomputed, walked);
+        ExpectSameClosestN(precomputed, walked);
+
+        for (Consistent* c : {&precomputed, &walked}) {
+            c->Add(MakeMember(20, 2.0));
+            c->RemoveByName(members[4]->Name());
+            c->ApplyChanges({MakeMember(21), MakeMember(22)}, {members[0]->Name()});
+        }
+        ExpectSamePlacement(precomputed, walked);
+        ExpectSameClosestN(precomputed, walked);
+    }
+}
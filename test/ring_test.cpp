@@ -0,0 +1,70 @@
+#include <consistent/ring.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace consistent;
+
+namespace {
+
+size_t ReferenceFindStart(const std::vector<uint64_t>& hashes, uint64_t key) {
+    auto it = std::lower_bound(hashes.begin(), hashes.end(), key);
+    return it == hashes.end() ? 0 : static_cast<size_t>(it - hashes.begin());
+}
+
+// Each hash, its neighbours, both ends of the key space and random keys
+void ExpectMatchesLowerBound(const Ring& ring, std::mt19937_64& rng) {
+    const std::vector<uint64_t>& hashes = ring.Hashes();
+    ASSERT_TRUE(std::is_sorted(hashes.begin(), hashes.end()));
+    std::vector<uint64_t> keys = {0, 1, std::numeric_limits<uint64_t>::max()};
+    for (uint64_t hash : hashes) {
+        keys.push_back(hash - 1);
+        keys.push_back(hash);
+        keys.push_back(hash + 1);
+    }
+    for (int i = 0; i < 2000; ++i) {
+        keys.push_back(rng());
+    }
+    for (uint64_t key : keys) {
+        ASSERT_EQ(ring.FindStart(key), ReferenceFindStart(hashes, key)) << "key " << key;
+    }
+}
+
+} // namespace
+
+TEST(Ring, FindStartMatchesLowerBound) {
+    for (unsigned bits : {0u, 8u, 16u}) {
+        SCOPED_TRACE(bits);
+        std::mt19937_64 rng(bits + 1);
+        for (size_t size : {size_t{1}, size_t{2}, Ring::BLOCK_SIZE - 1, Ring::BLOCK_SIZE, Ring::BLOCK_SIZE + 1,
+                            size_t{1000}, size_t{5000}}) {
+            SCOPED_TRACE(size);
+            Ring ring(bits);
+            for (size_t i = 0; i < size; ++i) {
+                ring.Insert(rng(), static_cast<uint32_t>(i % 7));
+            }
+            ring.Build();
+            ExpectMatchesLowerBound(ring, rng);
+
+            // Hashes packed into one jump table bucket, and the ring after some owners leave
+            Ring clustered(bits);
+            for (size_t i = 0; i < size; ++i) {
+                clustered.Insert(0x8000000000000000ULL | (rng() >> 40), static_cast<uint32_t>(i % 7));
+            }
+            clustered.Build();
+            ExpectMatchesLowerBound(clustered, rng);
+
+            std::vector<bool> removed = {true, false, false, true, false, false, false};
+            ring.RemoveOwners(removed);
+            ring.Build();
+            if (!ring.Empty()) {
+                ExpectMatchesLowerBound(ring, rng);
+            }
+        }
+    }
+}
@@ -0,0 +1,35 @@
+#include "test_util.h"
+
+#include <consistent/ringset.h>
+
+#include <memory>
+#include <string>
+
+using namespace consistent;
+
+TEST(RingSet, TenantsMatchStandaloneRings) {
+    auto members = MakeMembers(0, 12);
+    RingSet set(members, CreateCRC64Hasher());
+    TenantID small = set.AddTenant(97);
+    TenantID large = set.AddTenant(300, 1.5);
+    Consistent small_ring(members, Config(CreateCRC64Hasher(), 97));
+    Consistent large_ring(members, Config(CreateCRC64Hasher(), 300, DEFAULT_REPLICATION_FACTOR, 1.5));
+
+    auto compare = [&]() {
+        for (const auto& key : ProbeKeys()) {
+            ASSERT_EQ(set.LocateKey(small, key)->Name(), small_ring.LocateKey(key)->Name());
+            ASSERT_EQ(set.LocateKey(large, key)->Name(), large_ring.LocateKey(key)->Name());
+        }
+        EXPECT_EQ(set.LoadDistribution(large), large_ring.LoadDistribution());
+    };
+
+    compare();
+    set.Add(MakeMember(40));
+    small_ring.Add(MakeMember(40));
+    large_ring.Add(MakeMember(40));
+    compare();
+    set.RemoveByName(members[3]->Name());
+    small_ring.RemoveByName(members[3]->Name());
+    large_ring.RemoveByName(members[3]->Name());
+    compare();
+}
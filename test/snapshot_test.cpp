@@ -0,0 +1,84 @@
+#include "test_util.h"
+
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace consistent;
+
+TEST(Snapshot, RoundTrip) {
+    auto members = MakeMembers(0, 12);
+    Consistent c(members, Config(CreateXXH3Hasher()));
+    c.RemoveByName(members[3]->Name());
+    c.Add(MakeMember(40, 2.0));
+
+    std::vector<uint8_t> image = c.Serialize();
+    members.push_back(MakeMember(40, 2.0));
+    auto loaded = Consistent::LoadSnapshot(image.data(), image.size(), members, Config(CreateXXH3Hasher()));
+
+    ExpectSamePlacement(c, *loaded);
+    EXPECT_EQ(loaded->Epoch(), c.Epoch());
+    EXPECT_EQ(loaded->GetMembers().size(), 12u);
+    EXPECT_EQ(loaded->Serialize(), image);
+
+    // The loaded ring keeps working as a normal one
+    c.Add(MakeMember(50));
+    loaded->Add(MakeMember(50));
+    ExpectSamePlacement(c, *loaded);
+}
+
+TEST(Snapshot, RejectsCorruption) {
+    auto members = MakeMembers(0, 12);
+    Consistent c(members, Config(CreateXXH3Hasher()));
+    std::vector<uint8_t> image = c.Serialize();
+
+    for (size_t pos : {size_t{0}, size_t{70}, image.size() / 2, image.size() - 9}) {
+        std::vector<uint8_t> damaged = image;
+        damaged[pos] ^= 0x10;
+        SCOPED_TRACE(pos);
+        EXPECT_THROW(Consistent::LoadSnapshot(damaged.data(), damaged.size(), members, Config(CreateXXH3Hasher())),
+                     InvalidSnapshotException);
+    }
+    EXPECT_THROW(Consistent::LoadSnapshot(image.data(), image.size() - 8, members, Config(CreateXXH3Hasher())),
+                 InvalidSnapshotException);
+    EXPECT_THROW(Consistent::LoadSnapshot(image.data(), 40, members, Config(CreateXXH3Hasher())),
+                 InvalidSnapshotException);
+}
+
+TEST(Snapshot, RejectsMismatchingMembersAndConfig) {
+    auto members = MakeMembers(0, 12);
+    Consistent c(members, Config(CreateXXH3Hasher()));
+    std::vector<uint8_t> image = c.Serialize();
+
+    std::vector<std::shared_ptr<Member>> missing(members.begin(), members.begin() + 5);
+    EXPECT_THROW(Consistent::LoadSnapshot(image.data(), image.size(), missing, Config(CreateXXH3Hasher())),
+                 InvalidSnapshotException);
+
+    auto reweighted = members;
+    reweighted[0] = MakeMember(0, 3.0);
+    EXPECT_THROW(Consistent::LoadSnapshot(image.data(), image.size(), reweighted, Config(CreateXXH3Hasher())),
+                 InvalidSnapshotException);
+
+    EXPECT_THROW(Consistent::LoadSnapshot(image.data(), image.size(), members, Config(CreateXXH3Hasher(7))),
+                 InvalidSnapshotException);
+    EXPECT_THROW(Consistent::LoadSnapshot(image.data(), image.size(), members, Config(CreateXXH3Hasher(), 397)),
+                 InvalidSnapshotException);
+}
+
+TEST(Snapshot, LoadsFromMappedFile) {
+    auto members = MakeMembers(0, 12);
+    Consistent c(members, Config(CreateXXH3Hasher()));
+    std::vector<uint8_t> image = c.Serialize();
+
+    std::string path = ::testing::TempDir() + "consistent_snapshot_test.bin";
+    {
+        std::ofstream out(path, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(image.data()), static_cast<std::streamsize>(image.size()));
+    }
+    auto loaded = Consistent::LoadSnapshotFile(path, members, Config(CreateXXH3Hasher()));
+    ExpectSamePlacement(c, *loaded);
+    EXPECT_EQ(loaded->Serialize(), image);
+    std::remove(path.c_str());
+}
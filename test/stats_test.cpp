@@ -0,0 +1,75 @@
+#include "test_util.h"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace consistent;
+
+#if CONSISTENT_ENABLE_STATS
+
+TEST(Stats, CountsLookupsAndRebalances) {
+    std::vector<RebalanceEvent> events;
+    Config config(CreateCRC64Hasher());
+    config.stats_sink = [&](const RebalanceEvent& event) { events.push_back(event); };
+    Consistent c(MakeMembers(0, 10), std::move(config));
+
+    const int lookups = 64 * 50;
+    for (int i = 0; i < lookups; ++i) {
+        c.LocateKey("key" + std::to_string(i));
+    }
+    std::vector<Member*> owners;
+    c.LocateKeys(ProbeKeys(), owners);
+    c.GetClosestN("key", 3);
+
+    RingStats stats = c.Stats();
+    EXPECT_EQ(stats.lookups, lookups + ProbeKeys().size());
+    EXPECT_EQ(stats.closest_n_calls, 1u);
+    // The sample counter is per thread, so earlier lookups shift it by at most one
+    EXPECT_NEAR(double(stats.lookup_latency.Count()), lookups / LOOKUP_SAMPLE_INTERVAL, 1);
+    EXPECT_GT(stats.lookup_latency.Percentile(0.5), 0u);
+
+    std::vector<PartitionMove> moves = c.Add(MakeMember(20));
+    stats = c.Stats();
+    EXPECT_EQ(stats.rebalances, 1u);
+    EXPECT_EQ(stats.partitions_moved, moves.size());
+    EXPECT_EQ(stats.rebalance_latency.Count(), 1u);
+    EXPECT_FALSE(stats.rebalance_in_progress);
+    ASSERT_EQ(events.size(), 1u);
+    EXPECT_EQ(events[0].epoch, c.Epoch());
+    EXPECT_EQ(events[0].partitions_moved, moves.size());
+}
+
+// Every thread lands in a shard, and no lookup is lost when they share one
+TEST(Stats, CountsLookupsFromManyThreads) {
+    Consistent c(MakeMembers(0, 10), Config(CreateCRC64Hasher()));
+    const int threads = 2 * static_cast<int>(std::max(1u, std::thread::hardware_concurrency())) + 1;
+    const int per_thread = 1000;
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            for (int i = 0; i < per_thread; ++i) {
+                c.LocateKey(std::string_view("key"));
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    EXPECT_EQ(c.Stats().lookups, static_cast<uint64_t>(threads) * per_thread);
+}
+
+#else
+
+TEST(Stats, ZeroWithoutInstrumentation) {
+    Consistent c(MakeMembers(0, 10), Config(CreateCRC64Hasher()));
+    c.LocateKey("key");
+    c.Add(MakeMember(20));
+    RingStats stats = c.Stats();
+    EXPECT_EQ(stats.lookups, 0u);
+    EXPECT_EQ(stats.rebalances, 0u);
+    EXPECT_EQ(stats.lookup_latency.Count(), 0u);
+}
+
+#endif
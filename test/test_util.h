@@ -0,0 +1,66 @@
+#pragma once
+
+#include <consistent/consistent.h>
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace consistent {
+
+inline std::shared_ptr<Member> MakeMember(int i, double weight = 1.0) {
+    return std::make_shared<GatewayMember>("gw" + std::to_string(i), "10.0.0." + std::to_string(i), 8000 + i,
+                                           weight);
+}
+
+// Members first..first+count-1, alternating weights 1 and 2
+inline std::vector<std::shared_ptr<Member>> MakeMembers(int first, int count) {
+    std::vector<std::shared_ptr<Member>> members;
+    for (int i = first; i < first + count; ++i) {
+        members.push_back(MakeMember(i, 1.0 + i % 2));
+    }
+    return members;
+}
+
+// Enough keys to land in every one of the default 271 partitions
+inline std::vector<std::string> ProbeKeys() {
+    std::vector<std::string> keys;
+    for (int i = 0; i < 20000; ++i) {
+        keys.push_back("key" + std::to_string(i));
+    }
+    return keys;
+}
+
+// Owner name of every partition, found through the probe keys
+template <typename Ring>
+std::map<int, std::string> PartitionOwners(const Ring& ring) {
+    std::vector<std::string> keys = ProbeKeys();
+    std::vector<int> parts;
+    std::vector<Member*> owners;
+    ring.LocatePartitionIDs(keys, parts);
+    ring.LocateKeys(keys, owners);
+
+    std::map<int, std::string> result;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        result[parts[i]] = owners[i] ? owners[i]->Name() : "";
+    }
+    return result;
+}
+
+template <typename Ring>
+void ExpectSamePlacement(const Ring& a, const Ring& b) {
+    EXPECT_EQ(a.LoadDistribution(), b.LoadDistribution());
+    EXPECT_EQ(PartitionOwners(a), PartitionOwners(b));
+    for (const auto& key : {"alpha", "beta", "gamma", "delta"}) {
+        auto x = a.GetClosestN(key, 3), y = b.GetClosestN(key, 3);
+        ASSERT_EQ(x.size(), y.size());
+        for (size_t i = 0; i < x.size(); ++i) {
+            EXPECT_EQ(x[i]->Name(), y[i]->Name());
+        }
+    }
+}
+
+} // namespace consistent
@@ -0,0 +1,26 @@
+#include "test_util.h"
+
+#include <vector>
+
+using namespace consistent;
+
+TEST(Traffic, RebalanceByLoadSettles) {
+    Consistent c(MakeMembers(0, 12), Config(CreateCRC64Hasher()));
+    std::vector<double> qps(DEFAULT_PARTITION_COUNT, 1.0);
+    for (int part_id = 0; part_id < 30; ++part_id) {
+        qps[part_id] = 40.0;
+    }
+    c.RecordPartitionLoads(qps);
+
+    auto before = PartitionOwners(c);
+    std::vector<PartitionMove> moves = c.RebalanceByLoad();
+    auto after = PartitionOwners(c);
+    size_t changed = 0;
+    for (const auto& [part_id, owner] : after) {
+        changed += before.at(part_id) != owner;
+    }
+    EXPECT_EQ(moves.size(), changed);
+
+    // Running it again on the same traffic has nothing left to move
+    EXPECT_TRUE(c.RebalanceByLoad().empty());
+}
@@ -0,0 +1,47 @@
+#include "test_util.h"
+
+#include <cmath>
+#include <string>
+#include <unordered_map>
+
+using namespace consistent;
+
+namespace {
+
+// Every member stays under its weighted cap, and weight 2 members carry about
+// twice the partitions of weight 1 members
+void ExpectWeightedLoads(const Consistent& c, int partition_count, double load) {
+    double total_weight = 0;
+    for (const auto& member : c.GetMembers()) {
+        total_weight += member->Weight();
+    }
+
+    std::unordered_map<double, double> by_weight, members_by_weight;
+    auto loads = c.LoadDistribution();
+    for (const auto& member : c.GetMembers()) {
+        double owned = loads.at(member->Name());
+        EXPECT_LE(owned, std::ceil(partition_count * member->Weight() / total_weight * load)) << member->Name();
+        by_weight[member->Weight()] += owned;
+        members_by_weight[member->Weight()]++;
+    }
+
+    double light = by_weight[1.0] / members_by_weight[1.0];
+    double heavy = by_weight[2.0] / members_by_weight[2.0];
+    EXPECT_NEAR(heavy / light, 2.0, 0.3);
+}
+
+} // namespace
+
+TEST(Weights, LoadFollowsWeight) {
+    for (bool incremental : {false, true}) {
+        Config config(CreateXXH3Hasher(), 2711, 200);
+        config.incremental_rebalance = incremental;
+        Consistent c(MakeMembers(0, 12), std::move(config));
+        ExpectWeightedLoads(c, 2711, DEFAULT_LOAD);
+
+        c.Add(MakeMember(20, 2.0));
+        c.Add(MakeMember(21, 1.0));
+        c.RemoveByName(MakeMember(3)->Name());
+        ExpectWeightedLoads(c, 2711, DEFAULT_LOAD);
+    }
+}